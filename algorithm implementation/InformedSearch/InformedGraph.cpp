@@ -2,43 +2,1010 @@
 #include <unordered_map>
 #include <vector>
 #include <queue>
-#include <string>
 #include <set>
+#include <string>
 #include <limits>
 #include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <chrono>
+#include "../SearchCommon/SearchCommon.hpp"
 
 using namespace std;
+using search_common::capacityBytes;
+using search_common::ConcurrentUnionFind;
+using search_common::forEachDataLine;
+using search_common::isSeparator;
+using search_common::lineChunkStart;
+using search_common::parseInt;
+using search_common::relabelEndpoints;
+using search_common::skipSeparators;
+using search_common::validCsr;
+using search_common::LatencyHistogram;
+using search_common::MappedFile;
+using search_common::SearchStats;
+using search_common::WorkStealingPool;
+
+// Min-heap of node ids keyed by int with decrease-key; pos[v] is v's slot in the heap or -1
+template <int D = 4>
+class IndexedDaryHeap {
+private:
+    vector<int> heap;
+    vector<int> key;
+    vector<int> pos;
+
+public:
+    void resize(int n) {
+        if (static_cast<int>(pos.size()) < n) {
+            pos.resize(n, -1);
+            key.resize(n);
+        }
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    size_t size() const {
+        return heap.size();
+    }
+
+    size_t memoryBytes() const {
+        return capacityBytes(heap) + capacityBytes(key) + capacityBytes(pos);
+    }
+
+    bool contains(int v) const {
+        return pos[v] != -1;
+    }
+
+    int topKey() const {
+        return key[heap[0]];
+    }
+
+    // Insert v, or lower its key if it is already queued
+    void pushOrDecrease(int v, int k) {
+        if (pos[v] == -1) {
+            pos[v] = static_cast<int>(heap.size());
+            heap.push_back(v);
+        } else if (k >= key[v]) {
+            return;
+        }
+        key[v] = k;
+        siftUp(pos[v]);
+    }
+
+    int pop() {
+        int top = heap[0];
+        pos[top] = -1;
+        int last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            pos[last] = 0;
+            siftDown(0);
+        }
+        return top;
+    }
+
+    // Empty the heap without releasing capacity
+    void clear() {
+        for (int v : heap) pos[v] = -1;
+        heap.clear();
+    }
+
+private:
+    void siftUp(int i) {
+        int v = heap[i];
+        while (i > 0) {
+            int parent = (i - 1) / D;
+            if (key[heap[parent]] <= key[v]) break;
+            heap[i] = heap[parent];
+            pos[heap[i]] = i;
+            i = parent;
+        }
+        heap[i] = v;
+        pos[v] = i;
+    }
+
+    void siftDown(int i) {
+        int v = heap[i];
+        int n = static_cast<int>(heap.size());
+        while (true) {
+            int first = i * D + 1;
+            if (first >= n) break;
+            int best = first;
+            int last = min(first + D, n);
+            for (int c = first + 1; c < last; ++c) {
+                if (key[heap[c]] < key[heap[best]]) best = c;
+            }
+            if (key[heap[best]] >= key[v]) break;
+            heap[i] = heap[best];
+            pos[heap[i]] = i;
+            i = best;
+        }
+        heap[i] = v;
+        pos[v] = i;
+    }
+};
+
+// On-disk graph layout written by saveBinary and mapped by openBinary. Every section is an
+// 8-byte aligned array in native byte order; byte_order rejects files from the other endianness.
+struct BinaryGraphHeader {
+    enum Section {
+        Offsets, Targets, Costs, Heuristics, AndOrOffsets, AndOrChildren, AndOrIsAnd,
+        NameOffsets, Names, SortedNames, SectionCount
+    };
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t node_count;
+    uint64_t edge_slots;    // length of targets/costs, two per undirected edge
+    uint64_t and_or_count;
+    uint64_t name_bytes;
+    uint64_t section_offset[SectionCount];
+    uint64_t section_bytes[SectionCount];
+};
+
+// Result of a value-returning search: node ids from start to goal and the total cost
+struct PathResult {
+    bool found = false;
+    int cost = 0;
+    vector<int> path;
+};
+
+// Solution graph of an AND-OR search: each entry is a node of the plan and the children it is
+// solved through (all of them for an AND connector, one for an OR choice, none for the goal), root first
+struct AOSolution {
+    bool solved = false;
+    int cost = 0;
+    vector<pair<int, vector<int>>> plan;
+};
+
+// One (start, goal) pair of a batch, as dense node ids
+struct PathQuery {
+    int start;
+    int goal;
+};
+
+enum class SearchMode { BestFirst, AStar, BidirectionalAStar, IDAStar, AOStar, ContractionHierarchy };
 
 class InformedGraph {
 private:
-    unordered_map<string, vector<pair<string, int>>> graph; // graph[node] = [(neighbor, cost), ...]
-    unordered_map<string, int> heuristics; // heuristics[node] = h(n)
-    unordered_map<string, vector<pair<string, bool>>> and_or_graph; // parent -> [(child, is_and)]
+    // Interned node names: node_ids[name] = dense id, node_names[id] = name
+    unordered_map<string, int> node_ids;
+    vector<string> node_names;
+
+    // Edges recorded by addEdge/addAndOrEdge, frozen into CSR arrays before searching
+    vector<int> edge_from, edge_to, edge_cost;          // undirected, one entry per addEdge call
+
+    // Connected components of the addEdge graph, kept up to date as edges arrive so searches can
+    // reject a goal in another component without exploring anything
+    ConcurrentUnionFind components;
+    vector<int> and_or_from, and_or_to;                 // parent -> child
+    vector<char> and_or_flag;                           // is_and per AND-OR edge
+
+    // Frozen compressed-sparse-row adjacency: neighbors of v are targets[offsets[v] .. offsets[v + 1]).
+    // The searches only read the pointers, which refer either to the owned arrays below or
+    // straight into a binary file mapped by openBinary.
+    struct CompactGraph {
+        int node_count = 0;
+        const int* offsets = nullptr;
+        const int* targets = nullptr;
+        const int* costs = nullptr;
+        const int* heuristics = nullptr;                // h(n), kNoHeuristic if unset
+        const int* and_or_offsets = nullptr;
+        const int* and_or_children = nullptr;
+        const char* and_or_is_and = nullptr;
+
+        // Name table, only used when mapped: name of v is names[name_offsets[v] .. name_offsets[v + 1]),
+        // sorted_names lists ids in name order for binary search
+        const int* name_offsets = nullptr;
+        const char* names = nullptr;
+        const int* sorted_names = nullptr;
+
+        vector<int> offset_store, target_store, cost_store, heuristic_store;
+        vector<int> and_or_offset_store, and_or_child_store;
+        vector<char> and_or_flag_store;
+        shared_ptr<const MappedFile> mapping;
+
+        CompactGraph() = default;
+
+        CompactGraph(const CompactGraph& other) {
+            *this = other;
+        }
+
+        // Copies must point at their own storage, not at the source's
+        CompactGraph& operator=(const CompactGraph& other) {
+            if (this == &other) return *this;
+            node_count = other.node_count;
+            offset_store = other.offset_store;
+            target_store = other.target_store;
+            cost_store = other.cost_store;
+            heuristic_store = other.heuristic_store;
+            and_or_offset_store = other.and_or_offset_store;
+            and_or_child_store = other.and_or_child_store;
+            and_or_flag_store = other.and_or_flag_store;
+            mapping = other.mapping;
+            if (mapping) {
+                offsets = other.offsets;
+                targets = other.targets;
+                costs = other.costs;
+                heuristics = other.heuristics;
+                and_or_offsets = other.and_or_offsets;
+                and_or_children = other.and_or_children;
+                and_or_is_and = other.and_or_is_and;
+                name_offsets = other.name_offsets;
+                names = other.names;
+                sorted_names = other.sorted_names;
+            } else {
+                bindStorage();
+            }
+            return *this;
+        }
+
+        void bindStorage() {
+            offsets = offset_store.data();
+            targets = target_store.data();
+            costs = cost_store.data();
+            heuristics = heuristic_store.data();
+            and_or_offsets = and_or_offset_store.data();
+            and_or_children = and_or_child_store.data();
+            and_or_is_and = and_or_flag_store.data();
+            name_offsets = nullptr;
+            names = nullptr;
+            sorted_names = nullptr;
+        }
+    };
+    CompactGraph csr;
+    bool frozen = false;
+
+    // Nodes proven SOLVED by earlier AO* queries, keyed by (goal << 32 | node). Later queries for the
+    // same goal reuse them as solved leaves instead of re-exploring the subproblem.
+    struct AndOrMemo {
+        struct Entry {
+            int cost;
+            int connector;      // kAndConnector, kNoConnector or the AND-OR edge index of the OR choice
+        };
+        mutable shared_mutex lock;
+        unordered_map<uint64_t, Entry> solved;
+
+        AndOrMemo() = default;
+
+        AndOrMemo(const AndOrMemo& other) {
+            shared_lock<shared_mutex> guard(other.lock);
+            solved = other.solved;
+        }
+
+        AndOrMemo& operator=(const AndOrMemo& other) {
+            if (this == &other) return *this;
+            unordered_map<uint64_t, Entry> copy;
+            {
+                shared_lock<shared_mutex> guard(other.lock);
+                copy = other.solved;
+            }
+            unique_lock<shared_mutex> guard(lock);
+            solved.swap(copy);
+            return *this;
+        }
+
+        void clear() {
+            unique_lock<shared_mutex> guard(lock);
+            solved.clear();
+        }
+    };
+    mutable AndOrMemo and_or_memo;
+
+    // ALT landmark tables: landmark_dist[v * landmarks.size() + i] = d(landmarks[i], v)
+    vector<int> landmarks;
+    vector<int> landmark_dist;
+
+    static constexpr int kNoHeuristic = numeric_limits<int>::max();
+    static constexpr int kFutility = numeric_limits<int>::max() / 4;  // AO* cost of unsolvable nodes
+    static constexpr int kAndConnector = -1;
+    static constexpr int kNoConnector = -2;
+    static constexpr uint32_t kBinaryVersion = 1;
+    static constexpr int kInfinity = numeric_limits<int>::max();
+    static constexpr size_t kLoadChunkBytes = size_t(4) << 20;    // minimum edge-list text per parse task
+    static constexpr size_t kLoadVertexBlock = 4096;              // nodes or words per load task
+
+    // One line-aligned chunk of a parsed edge list: (u, v) label pairs and costs, their label
+    // range and, on a rejected line, its file offset and why it was rejected
+    struct EdgeChunk {
+        vector<int> endpoints;
+        vector<int> costs;
+        int low = numeric_limits<int>::max();
+        int high = numeric_limits<int>::min();
+        size_t error = numeric_limits<size_t>::max();
+        const char* error_reason = nullptr;
+    };
+
+    // One level of the explicit IDA* recursion: node, its g and the next edge to try
+    struct IdaFrame {
+        int node;
+        int g;
+        int edge;
+    };
+
+    // SMA* keeps an explicit search tree. A node stays in the open set while it has successors left
+    // to generate or regenerate; forgotten holds the lowest f among its children dropped for memory.
+    struct SmaNode {
+        int node;
+        int parent;
+        int g;
+        int f;
+        int depth;
+        int edge;
+        int forgotten;
+        int first_child;
+        int next_sibling;
+        int prev_sibling;
+        bool open;
+    };
+
+    // Search tree node plus the ordered-set entry that indexes it
+    static constexpr size_t kSmaNodeBytes = sizeof(SmaNode) + sizeof(tuple<int, int, int>) + 4 * sizeof(void*);
+
+    // Per-thread scratch state reused across queries; an entry is valid only when stamp[v] == generation
+    struct SearchWorkspace {
+        vector<unsigned> stamp;
+        vector<int> g_cost;
+        vector<int> came_from;
+        unsigned generation = 0;
+        IndexedDaryHeap<4> open_set;
+        vector<pair<int, int>> unpack_stack;
+        vector<IdaFrame> ida_stack;
+
+        void prepare(int n) {
+            if (static_cast<int>(stamp.size()) < n) {
+                stamp.resize(n, 0);
+                g_cost.resize(n);
+                came_from.resize(n);
+            }
+            open_set.resize(n);
+            open_set.clear();
+            if (++generation == 0) {
+                fill(stamp.begin(), stamp.end(), 0);
+                generation = 1;
+            }
+        }
+
+        int g(int v) const {
+            return stamp[v] == generation ? g_cost[v] : kInfinity;
+        }
+
+        void relax(int v, int g_value, int parent) {
+            stamp[v] = generation;
+            g_cost[v] = g_value;
+            came_from[v] = parent;
+        }
+
+        size_t memoryBytes() const {
+            return capacityBytes(stamp) + capacityBytes(g_cost) + capacityBytes(came_from) + open_set.memoryBytes() +
+                   capacityBytes(unpack_stack) + capacityBytes(ida_stack);
+        }
+    };
+
+    // Per-thread AO* state, reset per query by the generation stamp. parent lists are singly linked
+    // through parent_next so expanding a node never allocates once capacity is reached.
+    struct AndOrWorkspace {
+        enum Flag : char { Generated = 1, Expanded = 2, Solved = 4, FromMemo = 8, Pending = 16 };
+
+        vector<unsigned> stamp;
+        vector<unsigned> visit;
+        vector<int> cost;
+        vector<int> connector;
+        vector<char> flags;
+        vector<int> parent_head;
+        vector<int> parent_node;
+        vector<int> parent_next;
+        vector<int> touched;
+        vector<int> stack;
+        vector<int> zone;
+        IndexedDaryHeap<4> queue;
+        unsigned generation = 0;
+        unsigned visit_generation = 0;
+
+        void prepare(int n) {
+            if (static_cast<int>(stamp.size()) < n) {
+                stamp.resize(n, 0);
+                visit.resize(n, 0);
+                cost.resize(n);
+                connector.resize(n);
+                flags.resize(n);
+                parent_head.resize(n);
+            }
+            queue.resize(n);
+            parent_node.clear();
+            parent_next.clear();
+            touched.clear();
+            if (++generation == 0) {
+                fill(stamp.begin(), stamp.end(), 0);
+                generation = 1;
+            }
+        }
+
+        bool generated(int v) const {
+            return stamp[v] == generation;
+        }
+
+        void generate(int v) {
+            stamp[v] = generation;
+            flags[v] = Generated;
+            parent_head[v] = -1;
+            connector[v] = kNoConnector;
+            touched.push_back(v);
+        }
+
+        void addParent(int v, int parent) {
+            parent_node.push_back(parent);
+            parent_next.push_back(parent_head[v]);
+            parent_head[v] = static_cast<int>(parent_node.size()) - 1;
+        }
+
+        size_t memoryBytes() const {
+            return capacityBytes(stamp) + capacityBytes(visit) + capacityBytes(cost) + capacityBytes(connector) +
+                   capacityBytes(flags) + capacityBytes(parent_head) + capacityBytes(parent_node) +
+                   capacityBytes(parent_next) + capacityBytes(touched) + capacityBytes(stack) + capacityBytes(zone) +
+                   queue.memoryBytes();
+        }
+
+        // Start a fresh traversal mark; visit[v] == visit_generation means seen in this traversal
+        void newVisit() {
+            if (++visit_generation == 0) {
+                fill(visit.begin(), visit.end(), 0);
+                visit_generation = 1;
+            }
+        }
+    };
+
+    static AndOrWorkspace& threadAndOrWorkspace() {
+        thread_local AndOrWorkspace workspace;
+        return workspace;
+    }
+
+    // Two-thread bidirectional A*: each direction owns one side, and the other thread reads its labels
+    // through label[v] = (generation << 32) | g, so a stale entry is recognized without a reset
+    struct ConcurrentSide {
+        unique_ptr<atomic<uint64_t>[]> label;
+        vector<int> came_from;
+        IndexedDaryHeap<4> open_set;
+        atomic<long long> top_key{0};
+        int capacity = 0;
+
+        void prepare(int n) {
+            if (capacity < n) {
+                label.reset(new atomic<uint64_t>[n]);
+                for (int v = 0; v < n; ++v) label[v].store(0, memory_order_relaxed);
+                came_from.resize(n);
+                capacity = n;
+            }
+            open_set.resize(n);
+            open_set.clear();
+        }
+    };
+
+    struct ConcurrentBidirectionalWorkspace {
+        ConcurrentSide side[2];
+        uint32_t generation = 0;
+        atomic<uint64_t> best{0};      // (mu << 32) | meeting node
+        atomic<bool> done{false};
+
+        void prepare(int n) {
+            bool grew = side[0].capacity < n || side[1].capacity < n;
+            side[0].prepare(n);
+            side[1].prepare(n);
+            if (++generation == 0 || grew) {
+                for (ConcurrentSide& part : side) {
+                    for (int v = 0; v < part.capacity; ++v) part.label[v].store(0, memory_order_relaxed);
+                }
+                if (generation == 0) generation = 1;
+            }
+            best.store(~0ull, memory_order_relaxed);
+            done.store(false, memory_order_relaxed);
+        }
+
+        int g(int which, int v) const {
+            uint64_t value = side[which].label[v].load();
+            return static_cast<uint32_t>(value >> 32) == generation ? static_cast<int>(value & 0xffffffffu) : kInfinity;
+        }
+    };
+
+    static ConcurrentBidirectionalWorkspace& threadConcurrentWorkspace() {
+        thread_local ConcurrentBidirectionalWorkspace workspace;
+        return workspace;
+    }
+
+    // Bidirectional searches use slot 0 for the forward and slot 1 for the backward direction
+    static SearchWorkspace& threadWorkspace(int slot = 0) {
+        thread_local SearchWorkspace workspaces[2];
+        return workspaces[slot];
+    }
+
+    // Contraction hierarchy: every node has a rank, and each edge (original or shortcut) is stored
+    // once, in the upward list of its lower-ranked endpoint. up_middle is the contracted node a
+    // shortcut bypasses, or -1 for an original edge.
+    struct ContractionHierarchy {
+        vector<int> rank;
+        vector<int> up_offsets;
+        vector<int> up_targets;
+        vector<int> up_costs;
+        vector<int> up_middle;
+    };
+    ContractionHierarchy ch;
+
+    struct ChEdge {
+        int to;
+        int cost;
+        int middle;
+    };
+
+    struct ChShortcut {
+        int from;
+        int to;
+        int cost;
+    };
 
 public:
     // Add an undirected edge with a cost
     void addEdge(const string& u, const string& v, int cost = 1) {
-        graph[u].push_back({v, cost});
-        graph[v].push_back({u, cost});
+        if (!checkWritable()) return;
+        edge_from.push_back(internNode(u));
+        edge_to.push_back(internNode(v));
+        edge_cost.push_back(cost);
+        components.unite(edge_from.back(), edge_to.back());
+        frozen = false;
     }
 
-    // Set heuristic value for a node
+    // Set heuristic value for a node. Memoized AO* costs were computed with the old values.
     void setHeuristic(const string& node, int value) {
-        heuristics[node] = value;
+        if (!checkWritable()) return;
+        csr.heuristic_store[internNode(node)] = value;
+        and_or_memo.clear();
     }
 
     // Add AND-OR graph edges (parent -> [(child, is_and)])
     void addAndOrEdge(const string& parent, const string& child, bool is_and = true) {
-        and_or_graph[parent].push_back({child, is_and});
+        if (!checkWritable()) return;
+        and_or_from.push_back(internNode(parent));
+        and_or_to.push_back(internNode(child));
+        and_or_flag.push_back(is_and);
+        frozen = false;
+    }
+
+    // Build the CSR arrays from the recorded edges; searches call this on demand
+    void freeze() {
+        if (frozen) return;
+        int n = nodeCount();
+        size_t m = edge_from.size();
+
+        // Counting sort by source node keeps each neighbor list in insertion order
+        vector<int>& offsets = csr.offset_store;
+        offsets.assign(n + 1, 0);
+        for (size_t i = 0; i < m; ++i) {
+            ++offsets[edge_from[i] + 1];
+            ++offsets[edge_to[i] + 1];
+        }
+        for (int v = 0; v < n; ++v) offsets[v + 1] += offsets[v];
+        csr.target_store.resize(2 * m);
+        csr.cost_store.resize(2 * m);
+        vector<int> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < m; ++i) {
+            int a = cursor[edge_from[i]]++;
+            csr.target_store[a] = edge_to[i];
+            csr.cost_store[a] = edge_cost[i];
+            int b = cursor[edge_to[i]]++;
+            csr.target_store[b] = edge_from[i];
+            csr.cost_store[b] = edge_cost[i];
+        }
+
+        size_t k = and_or_from.size();
+        vector<int>& and_or_offsets = csr.and_or_offset_store;
+        and_or_offsets.assign(n + 1, 0);
+        for (size_t i = 0; i < k; ++i) ++and_or_offsets[and_or_from[i] + 1];
+        for (int v = 0; v < n; ++v) and_or_offsets[v + 1] += and_or_offsets[v];
+        csr.and_or_child_store.resize(k);
+        csr.and_or_flag_store.resize(k);
+        cursor.assign(and_or_offsets.begin(), and_or_offsets.end() - 1);
+        for (size_t i = 0; i < k; ++i) {
+            int a = cursor[and_or_from[i]]++;
+            csr.and_or_child_store[a] = and_or_to[i];
+            csr.and_or_flag_store[a] = and_or_flag[i];
+        }
+        csr.node_count = n;
+        csr.bindStorage();
+        landmarks.clear();
+        landmark_dist.clear();
+        ch = ContractionHierarchy();
+        and_or_memo.clear();
+        frozen = true;
+    }
+
+    // ------------------------ Binary Graph Files ------------------------
+    // Write the frozen graph (CSR, costs, heuristics, AND-OR edges and name table) for openBinary
+    bool saveBinary(const string& path) {
+        freeze();
+        int n = nodeCount();
+        size_t slots = csr.offsets[n];
+        size_t and_or_count = csr.and_or_offsets[n];
+
+        vector<int> name_offsets(n + 1, 0);
+        for (int v = 0; v < n; ++v) name_offsets[v + 1] = name_offsets[v] + static_cast<int>(nodeName(v).size());
+        vector<int> sorted_names(n);
+        for (int v = 0; v < n; ++v) sorted_names[v] = v;
+        sort(sorted_names.begin(), sorted_names.end(), [this](int a, int b) { return nodeName(a) < nodeName(b); });
+
+        BinaryGraphHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "IGRAPH\0", 8);
+        header.version = kBinaryVersion;
+        header.byte_order = 0x01020304;
+        header.node_count = n;
+        header.edge_slots = slots;
+        header.and_or_count = and_or_count;
+        header.name_bytes = name_offsets[n];
+
+        const void* sections[BinaryGraphHeader::SectionCount] = {
+            csr.offsets, csr.targets, csr.costs, csr.heuristics, csr.and_or_offsets, csr.and_or_children,
+            csr.and_or_is_and, name_offsets.data(), nullptr, sorted_names.data(),
+        };
+        uint64_t sizes[BinaryGraphHeader::SectionCount] = {
+            (n + 1) * sizeof(int), slots * sizeof(int), slots * sizeof(int), n * sizeof(int),
+            (n + 1) * sizeof(int), and_or_count * sizeof(int), and_or_count, (n + 1) * sizeof(int),
+            header.name_bytes, n * sizeof(int),
+        };
+        uint64_t position = alignTo8(sizeof(header));
+        for (int i = 0; i < BinaryGraphHeader::SectionCount; ++i) {
+            header.section_offset[i] = position;
+            header.section_bytes[i] = sizes[i];
+            position = alignTo8(position + sizes[i]);
+        }
+
+        ofstream out(path, ios::binary | ios::trunc);
+        if (!out) {
+            cerr << "Cannot write graph file " << path << endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (int i = 0; i < BinaryGraphHeader::SectionCount; ++i) {
+            padTo(out, header.section_offset[i]);
+            if (i == BinaryGraphHeader::Names) {
+                for (int v = 0; v < n; ++v) out.write(nodeName(v).data(), nodeName(v).size());
+            } else if (sizes[i] > 0) {
+                out.write(static_cast<const char*>(sections[i]), sizes[i]);
+            }
+        }
+        padTo(out, position);
+        return static_cast<bool>(out);
+    }
+
+    // Replace this graph with a file written by saveBinary. The arrays are used in place from the
+    // mapping, so the graph is ready for queries without parsing; it is read-only afterwards.
+    bool openBinary(const string& path) {
+        auto file = make_shared<MappedFile>();
+        if (!file->open(path)) {
+            cerr << "Cannot open graph file " << path << endl;
+            return false;
+        }
+        const char* base = file->data();
+        size_t file_size = file->size();
+        BinaryGraphHeader header;
+        if (file_size < sizeof(header)) return rejectBinary(path);
+        memcpy(&header, base, sizeof(header));
+        // Every count is stored in int offsets, which also keeps the section sizes below from overflowing
+        const uint64_t max_count = static_cast<uint64_t>(numeric_limits<int>::max());
+        if (memcmp(header.magic, "IGRAPH\0", 8) != 0 || header.version != kBinaryVersion ||
+            header.byte_order != 0x01020304 || header.node_count >= max_count || header.edge_slots > max_count ||
+            header.and_or_count > max_count || header.name_bytes > max_count) {
+            return rejectBinary(path);
+        }
+
+        uint64_t n = header.node_count;
+        uint64_t expected[BinaryGraphHeader::SectionCount] = {
+            (n + 1) * sizeof(int), header.edge_slots * sizeof(int), header.edge_slots * sizeof(int), n * sizeof(int),
+            (n + 1) * sizeof(int), header.and_or_count * sizeof(int), header.and_or_count, (n + 1) * sizeof(int),
+            header.name_bytes, n * sizeof(int),
+        };
+        for (int i = 0; i < BinaryGraphHeader::SectionCount; ++i) {
+            if (header.section_bytes[i] != expected[i] || header.section_offset[i] % 8 != 0 ||
+                header.section_offset[i] > file_size || file_size - header.section_offset[i] < expected[i]) {
+                return rejectBinary(path);
+            }
+        }
+        auto section = [&](int i) { return base + header.section_offset[i]; };
+
+        CompactGraph mapped;
+        mapped.node_count = static_cast<int>(n);
+        mapped.offsets = reinterpret_cast<const int*>(section(BinaryGraphHeader::Offsets));
+        mapped.targets = reinterpret_cast<const int*>(section(BinaryGraphHeader::Targets));
+        mapped.costs = reinterpret_cast<const int*>(section(BinaryGraphHeader::Costs));
+        mapped.heuristics = reinterpret_cast<const int*>(section(BinaryGraphHeader::Heuristics));
+        mapped.and_or_offsets = reinterpret_cast<const int*>(section(BinaryGraphHeader::AndOrOffsets));
+        mapped.and_or_children = reinterpret_cast<const int*>(section(BinaryGraphHeader::AndOrChildren));
+        mapped.and_or_is_and = section(BinaryGraphHeader::AndOrIsAnd);
+        mapped.name_offsets = reinterpret_cast<const int*>(section(BinaryGraphHeader::NameOffsets));
+        mapped.names = section(BinaryGraphHeader::Names);
+        mapped.sorted_names = reinterpret_cast<const int*>(section(BinaryGraphHeader::SortedNames));
+        mapped.mapping = file;
+        if (!validMapping(mapped, header, sharedPool())) return rejectBinary(path);
+
+        *this = InformedGraph();
+        csr = mapped;
+        frozen = true;
+        indexComponents(sharedPool());
+        return true;
+    }
+
+    // Whether a path can exist between two nodes; O(alpha(n)) and safe during concurrent queries
+    bool connected(int a, int b) const {
+        return a == b || components.connected(a, b);
+    }
+
+    bool connected(const string& a, const string& b) const {
+        int s = nodeId(a), t = nodeId(b);
+        return s >= 0 && t >= 0 && connected(s, t);
+    }
+
+    // ------------------------ Text Loading ------------------------
+    // Replace this graph with an undirected edge list, one "u v [cost]" line per edge with integer
+    // node labels, separated by blanks, tabs or commas; the cost defaults to 1 and node names are
+    // the labels in decimal. A negative cost or a fourth column rejects the file. Blank lines and lines starting with '#' or '%' are skipped, and so is
+    // a first line that does not start with a number (a CSV header). The file is mapped and parsed
+    // in line-aligned chunks on every pool thread, and the CSR is built directly by a parallel
+    // counting sort; neighbor lists come out sorted by (target, cost) instead of in file order.
+    bool loadEdgeList(const string& path) {
+        return loadEdgeList(path, sharedPool());
+    }
+
+    bool loadEdgeList(const string& path, WorkStealingPool& pool) {
+        MappedFile file;
+        if (!file.open(path)) {
+            cerr << "Cannot open edge list " << path << endl;
+            return false;
+        }
+        const char* data = file.data();
+        size_t size = file.size();
+        // A few chunks per thread for balance, but no more, since the sort keeps a slice per chunk
+        size_t chunk_bytes = max(kLoadChunkBytes, size / (8 * pool.size()) + 1);
+        size_t chunk_count = (size + chunk_bytes - 1) / chunk_bytes;
+        vector<EdgeChunk> chunks(chunk_count);
+        pool.parallelFor(chunk_count, [&](size_t i) {
+            parseEdgeChunk(data, lineChunkStart(data, size, chunk_bytes, i), lineChunkStart(data, size, chunk_bytes, i + 1), chunks[i]);
+        });
+        const EdgeChunk* rejected = nullptr;
+        for (const EdgeChunk& chunk : chunks) {
+            if (chunk.error_reason && (!rejected || chunk.error < rejected->error)) rejected = &chunk;
+        }
+        if (rejected) {
+            cerr << rejected->error_reason << " at line " << count(data, data + rejected->error, '\n') + 1 << " of " << path << endl;
+            return false;
+        }
+
+        vector<int> labels = relabelEndpoints(chunks, pool);
+        int n = static_cast<int>(labels.size());
+        *this = InformedGraph();
+        node_names.resize(n);
+        pool.parallelFor((static_cast<size_t>(n) + kLoadVertexBlock - 1) / kLoadVertexBlock, [&](size_t block) {
+            for (size_t v = block * kLoadVertexBlock; v < min<size_t>(n, (block + 1) * kLoadVertexBlock); ++v) node_names[v] = to_string(labels[v]);
+        });
+        node_ids.reserve(n);
+        for (int v = 0; v < n; ++v) node_ids.emplace(node_names[v], v);
+        csr.heuristic_store.assign(n, kNoHeuristic);
+
+        // The recorded edge list stays in file order, so later edits refreeze the same graph
+        vector<size_t> first_edge(chunk_count + 1, 0);
+        for (size_t i = 0; i < chunk_count; ++i) first_edge[i + 1] = first_edge[i] + chunks[i].costs.size();
+        edge_from.resize(first_edge[chunk_count]);
+        edge_to.resize(first_edge[chunk_count]);
+        edge_cost.resize(first_edge[chunk_count]);
+        pool.parallelFor(chunk_count, [&](size_t i) {
+            const EdgeChunk& chunk = chunks[i];
+            for (size_t k = 0; k < chunk.costs.size(); ++k) {
+                edge_from[first_edge[i] + k] = chunk.endpoints[2 * k];
+                edge_to[first_edge[i] + k] = chunk.endpoints[2 * k + 1];
+                edge_cost[first_edge[i] + k] = chunk.costs[k];
+            }
+        });
+
+        // Two-pass parallel counting sort with no shared counters. Pass one moves every directed
+        // edge into the bucket of kLoadVertexBlock consecutive sources it starts at, each chunk
+        // writing to its own precomputed slice of every bucket; pass two sorts a bucket in cache.
+        size_t buckets = (static_cast<size_t>(n) + kLoadVertexBlock - 1) / kLoadVertexBlock;
+        vector<size_t> slice(buckets * chunk_count + 1, 0);    // bucket-major, chunk-minor
+        pool.parallelFor(chunk_count, [&](size_t i) {
+            const vector<int>& endpoints = chunks[i].endpoints;
+            for (size_t e = 0; e < endpoints.size(); ++e) ++slice[endpoints[e] / kLoadVertexBlock * chunk_count + i + 1];
+        });
+        for (size_t k = 0; k < buckets * chunk_count; ++k) slice[k + 1] += slice[k];
+        vector<uint64_t> staged(slice.back());                 // (source within bucket << 32) | target
+        vector<int> staged_cost(slice.back());
+        pool.parallelFor(chunk_count, [&](size_t i) {
+            vector<size_t> next(buckets);
+            for (size_t bucket = 0; bucket < buckets; ++bucket) next[bucket] = slice[bucket * chunk_count + i];
+            auto place = [&](int u, int v, int cost) {
+                size_t at = next[u / kLoadVertexBlock]++;
+                staged[at] = uint64_t(u % kLoadVertexBlock) << 32 | static_cast<uint32_t>(v);
+                staged_cost[at] = cost;
+            };
+            EdgeChunk& chunk = chunks[i];
+            for (size_t k = 0; k < chunk.costs.size(); ++k) {
+                place(chunk.endpoints[2 * k], chunk.endpoints[2 * k + 1], chunk.costs[k]);
+                place(chunk.endpoints[2 * k + 1], chunk.endpoints[2 * k], chunk.costs[k]);
+            }
+            chunk = EdgeChunk();
+        });
+
+        vector<int>& offsets = csr.offset_store;
+        offsets.assign(n + 1, 0);
+        offsets[n] = static_cast<int>(staged.size());
+        csr.target_store.resize(staged.size());
+        csr.cost_store.resize(staged.size());
+        pool.parallelFor(buckets, [&](size_t bucket) {
+            size_t begin = slice[bucket * chunk_count], end = slice[(bucket + 1) * chunk_count];
+            int first_vertex = static_cast<int>(bucket * kLoadVertexBlock);
+            vector<tuple<uint32_t, uint32_t, int>> entries(end - begin);
+            for (size_t k = begin; k < end; ++k) entries[k - begin] = make_tuple(uint32_t(staged[k] >> 32), uint32_t(staged[k]), staged_cost[k]);
+            sort(entries.begin(), entries.end());
+            int vertex = first_vertex;
+            int last = static_cast<int>(min<size_t>(n, (bucket + 1) * kLoadVertexBlock));
+            for (size_t k = 0; k < entries.size(); ++k) {
+                int source = first_vertex + static_cast<int>(get<0>(entries[k]));
+                while (vertex <= source) offsets[vertex++] = static_cast<int>(begin + k);
+                csr.target_store[begin + k] = static_cast<int>(get<1>(entries[k]));
+                csr.cost_store[begin + k] = get<2>(entries[k]);
+            }
+            while (vertex < last) offsets[vertex++] = static_cast<int>(end);
+        });
+
+        csr.and_or_offset_store.assign(n + 1, 0);
+        csr.node_count = n;
+        csr.bindStorage();
+        frozen = true;
+        indexComponents(pool);
+        return true;
+    }
+
+    // Set heuristics from "node h" lines (same separators and comments as loadEdgeList); node
+    // names are any run of non-separator characters. Unknown nodes are added.
+    bool loadHeuristics(const string& path) {
+        return loadHeuristics(path, sharedPool());
+    }
+
+    bool loadHeuristics(const string& path, WorkStealingPool& pool) {
+        if (!checkWritable()) return false;
+        MappedFile file;
+        if (!file.open(path)) {
+            cerr << "Cannot open heuristic file " << path << endl;
+            return false;
+        }
+        const char* data = file.data();
+        size_t size = file.size();
+        size_t chunk_bytes = max(kLoadChunkBytes, size / (8 * pool.size()) + 1);
+        size_t chunk_count = (size + chunk_bytes - 1) / chunk_bytes;
+        vector<vector<pair<string_view, int>>> values(chunk_count);
+        vector<size_t> errors(chunk_count, numeric_limits<size_t>::max());
+        pool.parallelFor(chunk_count, [&](size_t i) {
+            forEachDataLine(data, lineChunkStart(data, size, chunk_bytes, i), lineChunkStart(data, size, chunk_bytes, i + 1),
+                            [&](const char* line, const char* line_end) {
+                const char* p = line;
+                skipSeparators(p, line_end);
+                const char* name = p;
+                while (p < line_end && !isSeparator(*p)) ++p;
+                string_view node(name, p - name);
+                skipSeparators(p, line_end);
+                int value;
+                if (!parseInt(p, line_end, value)) {
+                    if (line == data) return true;    // header
+                    errors[i] = static_cast<size_t>(line - data);
+                    return false;
+                }
+                values[i].push_back({node, value});
+                return true;
+            });
+        });
+        size_t error = *min_element(errors.begin(), errors.end());
+        if (error != numeric_limits<size_t>::max()) {
+            cerr << "Malformed heuristic at line " << count(data, data + error, '\n') + 1 << " of " << path << endl;
+            return false;
+        }
+        for (const auto& chunk : values) {
+            for (const auto& entry : chunk) csr.heuristic_store[internNode(string(entry.first))] = entry.second;
+        }
+        return true;
+    }
+
+    bool isMapped() const {
+        return csr.mapping != nullptr;
+    }
+
+    // ------------------------ ALT Landmarks ------------------------
+    // Pick landmarks by farthest-point selection and store exact distances from each of them.
+    // A* then uses h(v) = max_i |d(L_i, goal) - d(L_i, v)|, which is admissible for any goal.
+    void precomputeLandmarks(int count) {
+        freeze();
+        int n = nodeCount();
+        landmarks.clear();
+        landmark_dist.clear();
+        if (n == 0 || count <= 0) return;
+        count = min(count, n);
+
+        vector<vector<int>> tables;
+        vector<int> dist(n);
+        // Distance from the nearest chosen landmark; unreachable nodes rank as farthest so
+        // every component gets a landmark before any component gets a second one
+        vector<long long> nearest(n, numeric_limits<long long>::max());
+
+        dijkstraFrom(0, dist);
+        int next = static_cast<int>(max_element(dist.begin(), dist.end(), [](int a, int b) {
+            return (a == kInfinity ? -1 : a) < (b == kInfinity ? -1 : b);
+        }) - dist.begin());
+
+        while (static_cast<int>(landmarks.size()) < count) {
+            landmarks.push_back(next);
+            dijkstraFrom(next, dist);
+            tables.push_back(dist);
+            for (int v = 0; v < n; ++v) {
+                long long d = dist[v] == kInfinity ? numeric_limits<long long>::max() / 2 : dist[v];
+                nearest[v] = min(nearest[v], d);
+            }
+            next = static_cast<int>(max_element(nearest.begin(), nearest.end()) - nearest.begin());
+            if (nearest[next] == 0) break;  // every node is already a landmark
+        }
+
+        size_t k = landmarks.size();
+        landmark_dist.resize(static_cast<size_t>(n) * k);
+        for (int v = 0; v < n; ++v) {
+            for (size_t i = 0; i < k; ++i) landmark_dist[v * k + i] = tables[i][v];
+        }
+    }
+
+    size_t landmarkCount() const {
+        return landmarks.size();
+    }
+
+    int nodeCount() const {
+        return isMapped() ? csr.node_count : static_cast<int>(node_names.size());
+    }
+
+    // Dense id of a node, or -1 if the name was never added
+    int nodeId(const string& name) const {
+        if (isMapped()) {
+            const int* first = csr.sorted_names;
+            const int* last = first + csr.node_count;
+            const int* it = lower_bound(first, last, name, [this](int id, const string& key) { return nodeName(id) < key; });
+            return it != last && nodeName(*it) == name ? *it : -1;
+        }
+        auto it = node_ids.find(name);
+        return it == node_ids.end() ? -1 : it->second;
+    }
+
+    string_view nodeName(int id) const {
+        if (isMapped()) {
+            return string_view(csr.names + csr.name_offsets[id], csr.name_offsets[id + 1] - csr.name_offsets[id]);
+        }
+        return node_names[id];
     }
 
     // Display the graph
     void iterate() {
-        for (const auto& node : graph) {
-            cout << node.first << " -> [";
-            for (size_t i = 0; i < node.second.size(); ++i) {
-                cout << "(" << node.second[i].first << ", " << node.second[i].second << ")";
-                if (i != node.second.size() - 1) cout << ", ";
+        freeze();
+        for (int v = 0; v < nodeCount(); ++v) {
+            if (csr.offsets[v] == csr.offsets[v + 1]) continue;
+            cout << nodeName(v) << " -> [";
+            for (int e = csr.offsets[v]; e < csr.offsets[v + 1]; ++e) {
+                cout << "(" << nodeName(csr.targets[e]) << ", " << csr.costs[e] << ")";
+                if (e != csr.offsets[v + 1] - 1) cout << ", ";
             }
             cout << "]" << endl;
         }
@@ -46,150 +1013,1404 @@ public:
 
     // ------------------------ Best First Search ------------------------
     void bestFirstSearch(const string& start, const string& goal) {
-        set<string> visited;
-        // priority_queue with pair<heuristic, node>, min-heap
-        priority_queue<pair<int, string>, vector<pair<int, string>>, greater<pair<int, string>>> pq;
-        pq.push({getHeuristic(start), start});
-
+        PathResult result = bestFirstQuery(start, goal);
         cout << "Best First Search Path: ";
-        while (!pq.empty()) {
-            pair<int, string> top = pq.top();
-            int h = top.first;
-            string current = top.second;
-            pq.pop();
+        if (!result.found) {
+            cout << "Goal not reachable" << endl;
+            return;
+        }
+        printPath(result.path);
+    }
 
-            if (current == goal) {
-                cout << current << endl;
-                return;
-            }
+    PathResult bestFirstQuery(const string& start, const string& goal, SearchStats* stats = nullptr) {
+        freeze();
+        PathResult result;
+        int s = nodeId(start), t = nodeId(goal);
+        if (s >= 0 && t >= 0) bestFirstQuery(s, t, result, stats);
+        return result;
+    }
 
-            if (visited.find(current) != visited.end()) continue;
-            visited.insert(current);
+    // Greedy search ordered by h(n) alone; each node is queued once, when first discovered
+    bool bestFirstQuery(int start, int goal, PathResult& result, SearchStats* stats = nullptr) const {
+        SEARCH_TIMER(stats, "best_first");
+        SearchWorkspace& ws = threadWorkspace();
+        ws.prepare(nodeCount());
+        SEARCH_STAT_MAX(stats, peak_memory, ws.memoryBytes());
+        result.found = false;
+        result.cost = 0;
+        result.path.clear();
+        if (!connected(start, goal)) return false;
 
-            cout << current << " -> ";
+        ws.relax(start, 0, -1);
+        ws.open_set.pushOrDecrease(start, getHeuristic(start));
+        SEARCH_STAT_ADD(stats, pushes, 1);
 
-            for (const auto& neighbor : graph[current]) {
-                if (visited.find(neighbor.first) == visited.end()) {
-                    pq.push({getHeuristic(neighbor.first), neighbor.first});
+        while (!ws.open_set.empty()) {
+            SEARCH_STAT_MAX(stats, peak_frontier, ws.open_set.size());
+            int current = ws.open_set.pop();
+            SEARCH_STAT_ADD(stats, pops, 1);
+            if (current == goal) {
+                collectPath(ws, goal, result);
+                return true;
+            }
+
+            SEARCH_STAT_ADD(stats, expanded, 1);
+            SEARCH_STAT_ADD(stats, generated, csr.offsets[current + 1] - csr.offsets[current]);
+            for (int e = csr.offsets[current]; e < csr.offsets[current + 1]; ++e) {
+                int neighbor = csr.targets[e];
+                if (ws.g(neighbor) == kInfinity) {
+                    ws.relax(neighbor, ws.g_cost[current] + csr.costs[e], current);
+                    ws.open_set.pushOrDecrease(neighbor, getHeuristic(neighbor));
+                    SEARCH_STAT_ADD(stats, pushes, 1);
                 }
             }
         }
-        cout << "Goal not reachable" << endl;
+        return false;
     }
 
     // ------------------------ A* Search ------------------------
     void aStarSearch(const string& start, const string& goal) {
-        // priority_queue with tuple<f, g, node>, min-heap
-        using T = tuple<int, int, string>;
-        priority_queue<T, vector<T>, greater<T>> open_set;
-        open_set.push({getHeuristic(start), 0, start});
-
-        unordered_map<string, string> came_from;
-        unordered_map<string, int> g_cost;
-        g_cost[start] = 0;
-
-        while (!open_set.empty()) {
-            tuple<int, int, string> top = open_set.top();
-            int f = get<0>(top);
-            int g = get<1>(top);
-            string current = get<2>(top);
-            open_set.pop();
+        PathResult result = aStarQuery(start, goal);
+        if (!result.found) {
+            cout << "Goal not reachable" << endl;
+            return;
+        }
+        cout << "A* Search Path: ";
+        printPath(result.path);
+    }
+
+    PathResult aStarQuery(const string& start, const string& goal, SearchStats* stats = nullptr) {
+        freeze();
+        PathResult result;
+        int s = nodeId(start), t = nodeId(goal);
+        if (s >= 0 && t >= 0) aStarQuery(s, t, result, stats);
+        return result;
+    }
+
+    // A* on the frozen graph using an indexed heap with decrease-key and the calling thread's
+    // workspace; once warmed up, repeated queries into the same result do not allocate
+    bool aStarQuery(int start, int goal, PathResult& result, SearchStats* stats = nullptr) const {
+        SEARCH_TIMER(stats, "a_star");
+        SearchWorkspace& ws = threadWorkspace();
+        ws.prepare(nodeCount());
+        SEARCH_STAT_MAX(stats, peak_memory, ws.memoryBytes());
+        result.found = false;
+        result.cost = 0;
+        result.path.clear();
+        if (!connected(start, goal)) return false;
 
+        ws.relax(start, 0, -1);
+        ws.open_set.pushOrDecrease(start, potential(start, goal));
+        SEARCH_STAT_ADD(stats, pushes, 1);
+
+        while (!ws.open_set.empty()) {
+            SEARCH_STAT_MAX(stats, peak_frontier, ws.open_set.size());
+            int current = ws.open_set.pop();
+            SEARCH_STAT_ADD(stats, pops, 1);
             if (current == goal) {
-                vector<string> path = reconstructPath(came_from, current);
-                cout << "A* Search Path: ";
-                for (size_t i = 0; i < path.size(); ++i) {
-                    cout << path[i];
-                if (i != path.size() - 1) cout << " -> ";
+                collectPath(ws, goal, result);
+                return true;
             }
-            cout << endl;
+
+            SEARCH_STAT_ADD(stats, expanded, 1);
+            SEARCH_STAT_ADD(stats, generated, csr.offsets[current + 1] - csr.offsets[current]);
+            int g = ws.g_cost[current];
+            for (int e = csr.offsets[current]; e < csr.offsets[current + 1]; ++e) {
+                int neighbor = csr.targets[e];
+                int new_g = g + csr.costs[e];
+                if (new_g < ws.g(neighbor)) {
+                    ws.relax(neighbor, new_g, current);
+                    ws.open_set.pushOrDecrease(neighbor, new_g + potential(neighbor, goal));
+                    SEARCH_STAT_ADD(stats, pushes, 1);
+                }
+            }
+        }
+        return false;
+    }
+
+    // ------------------------ IDA* Search ------------------------
+    // Depth-first contours of increasing f = g + h. Memory is one frame per path edge plus a
+    // transposition table of the best g per node within the current contour: a node reached again
+    // at no better g was already searched with at least as much budget and is skipped, which also
+    // cuts cycles. The next contour is the smallest f that exceeded the current one.
+    void idaStarSearch(const string& start, const string& goal) {
+        PathResult result = idaStarQuery(start, goal);
+        if (!result.found) {
+            cout << "Goal not reachable" << endl;
+            return;
+        }
+        cout << "IDA* Search Path: ";
+        printPath(result.path);
+    }
+
+    PathResult idaStarQuery(const string& start, const string& goal, SearchStats* stats = nullptr) {
+        freeze();
+        PathResult result;
+        int s = nodeId(start), t = nodeId(goal);
+        if (s >= 0 && t >= 0) idaStarQuery(s, t, result, stats);
+        return result;
+    }
+
+    bool idaStarQuery(int start, int goal, PathResult& result, SearchStats* stats = nullptr) const {
+        SEARCH_TIMER(stats, "ida_star");
+        SearchWorkspace& ws = threadWorkspace();
+        vector<IdaFrame>& stack = ws.ida_stack;
+        result.found = false;
+        result.cost = 0;
+        result.path.clear();
+        if (!connected(start, goal)) return false;
+
+        long long threshold = potential(start, goal);
+        while (threshold < kInfinity) {
+            ws.prepare(nodeCount());
+            ws.relax(start, 0, -1);
+            stack.clear();
+            stack.push_back({start, 0, csr.offsets[start]});
+            long long next_threshold = kInfinity;
+
+            while (!stack.empty()) {
+                IdaFrame& top = stack.back();
+                if (top.node == goal) {
+                    result.found = true;
+                    result.cost = top.g;
+                    for (const IdaFrame& frame : stack) result.path.push_back(frame.node);
+                    SEARCH_STAT_MAX(stats, peak_memory, ws.memoryBytes());
+                    return true;
+                }
+                if (top.edge == csr.offsets[top.node + 1]) {
+                    stack.pop_back();
+                    SEARCH_STAT_ADD(stats, pops, 1);
+                    continue;
+                }
+                if (top.edge == csr.offsets[top.node]) SEARCH_STAT_ADD(stats, expanded, 1);
+
+                int e = top.edge++;
+                SEARCH_STAT_ADD(stats, generated, 1);
+                int neighbor = csr.targets[e];
+                int new_g = top.g + csr.costs[e];
+                if (new_g >= ws.g(neighbor)) continue;
+                long long f = static_cast<long long>(new_g) + potential(neighbor, goal);
+                if (f > threshold) {
+                    next_threshold = min(next_threshold, f);
+                    continue;
+                }
+                ws.relax(neighbor, new_g, top.node);
+                stack.push_back({neighbor, new_g, csr.offsets[neighbor]});
+                SEARCH_STAT_ADD(stats, pushes, 1);
+                SEARCH_STAT_MAX(stats, peak_frontier, stack.size());
+            }
+            threshold = next_threshold;
+        }
+        SEARCH_STAT_MAX(stats, peak_memory, ws.memoryBytes());
+        return false;
+    }
+
+    // ------------------------ SMA* Search ------------------------
+    // Simplified memory-bounded A*: best-first over an explicit search tree whose size is capped by
+    // memory_bytes. When the cap is hit, the shallowest highest-f leaf is dropped and its f is kept
+    // in its parent, which regenerates it only if that branch becomes the best again. A node's f is
+    // backed up to the minimum over its children once all of them are generated. The answer is
+    // optimal whenever the optimal path fits in the budget; otherwise the best path that fits is
+    // returned, or nothing if no path fits.
+    void smaStarSearch(const string& start, const string& goal, size_t memory_bytes) {
+        PathResult result = smaStarQuery(start, goal, memory_bytes);
+        if (!result.found) {
+            cout << "Goal not reachable within " << memory_bytes << " bytes" << endl;
             return;
         }
+        cout << "SMA* Search Path: ";
+        printPath(result.path);
+    }
+
+    PathResult smaStarQuery(const string& start, const string& goal, size_t memory_bytes, SearchStats* stats = nullptr) {
+        freeze();
+        PathResult result;
+        int s = nodeId(start), t = nodeId(goal);
+        if (s >= 0 && t >= 0) smaStarQuery(s, t, result, memory_bytes, stats);
+        return result;
+    }
+
+    bool smaStarQuery(int start, int goal, PathResult& result, size_t memory_bytes, SearchStats* stats = nullptr) const {
+        SEARCH_TIMER(stats, "sma_star");
+        result.found = false;
+        result.cost = 0;
+        result.path.clear();
+        if (!connected(start, goal)) return false;
+        size_t capacity = memory_bytes / kSmaNodeBytes;
+        if (capacity == 0) return false;
 
-            for (const auto& neighbor : graph[current]) {
-                int new_g = g + neighbor.second;
-                if (g_cost.find(neighbor.first) == g_cost.end() || new_g < g_cost[neighbor.first]) {
-                    g_cost[neighbor.first] = new_g;
-                    int f = new_g + getHeuristic(neighbor.first);
-                    open_set.push({f, new_g, neighbor.first});
-                    came_from[neighbor.first] = current;
+        // Best g per graph node and the parent it came from: a strictly worse duplicate is never
+        // generated, an equal one only from the same parent, i.e. when it is being regenerated
+        SearchWorkspace& ws = threadWorkspace();
+        ws.prepare(nodeCount());
+
+        // The budget only caps live slots; an effectively unbounded one must not be allocated up front
+        vector<SmaNode> tree;
+        tree.reserve(min(capacity, static_cast<size_t>(nodeCount())));
+        vector<int> free_slots;
+        set<tuple<int, int, int>> open;   // (f, -depth, slot): begin is the best, rbegin the worst
+        auto openKey = [&](int slot) { return make_tuple(tree[slot].f, -tree[slot].depth, slot); };
+        auto setOpen = [&](int slot, bool value) {
+            if (tree[slot].open == value) return;
+            tree[slot].open = value;
+            if (value) open.insert(openKey(slot));
+            else open.erase(openKey(slot));
+        };
+        auto setF = [&](int slot, int f) {
+            if (tree[slot].open) open.erase(openKey(slot));
+            tree[slot].f = f;
+            if (tree[slot].open) open.insert(openKey(slot));
+        };
+        auto newNode = [&](int node, int parent, int g, int f, int depth) {
+            int slot;
+            if (free_slots.empty()) {
+                slot = static_cast<int>(tree.size());
+                tree.emplace_back();
+            } else {
+                slot = free_slots.back();
+                free_slots.pop_back();
+            }
+            tree[slot] = {node, parent, g, f, depth, csr.offsets[node], kInfinity, -1, -1, -1, false};
+            if (parent != -1) {
+                tree[slot].next_sibling = tree[parent].first_child;
+                if (tree[parent].first_child != -1) tree[tree[parent].first_child].prev_sibling = slot;
+                tree[parent].first_child = slot;
+            }
+            setOpen(slot, true);
+            SEARCH_STAT_ADD(stats, pushes, 1);
+            SEARCH_STAT_MAX(stats, peak_frontier, open.size());
+            SEARCH_STAT_MAX(stats, peak_memory, ws.memoryBytes() + (tree.size() - free_slots.size()) * kSmaNodeBytes);
+        };
+        // A fully generated node's f is the least f among its children, kept or forgotten
+        auto backUp = [&](int slot) {
+            for (; slot != -1; slot = tree[slot].parent) {
+                const SmaNode& current = tree[slot];
+                if (current.edge != csr.offsets[current.node + 1]) return;
+                int least = current.forgotten;
+                for (int c = current.first_child; c != -1; c = tree[c].next_sibling) least = min(least, tree[c].f);
+                if (least <= current.f) return;
+                setF(slot, least);
+            }
+        };
+        auto removeLeaf = [&](int slot) {
+            const SmaNode& leaf = tree[slot];
+            int parent = leaf.parent;
+            setOpen(slot, false);
+            if (leaf.prev_sibling != -1) tree[leaf.prev_sibling].next_sibling = leaf.next_sibling;
+            else tree[parent].first_child = leaf.next_sibling;
+            if (leaf.next_sibling != -1) tree[leaf.next_sibling].prev_sibling = leaf.prev_sibling;
+            tree[parent].forgotten = min(tree[parent].forgotten, leaf.f);
+            free_slots.push_back(slot);
+            setOpen(parent, true);
+            backUp(parent);
+        };
+        // Nothing can be reached below this leaf: drop it for good
+        auto killLeaf = [&](int slot) {
+            setF(slot, kInfinity);
+            removeLeaf(slot);
+        };
+
+        ws.relax(start, 0, -1);
+        newNode(start, -1, 0, potential(start, goal), 0);
+
+        while (!open.empty()) {
+            int best = get<2>(*open.begin());
+            SEARCH_STAT_ADD(stats, pops, 1);
+            if (tree[best].f >= kInfinity) return false;
+            if (tree[best].node == goal) {
+                result.found = true;
+                result.cost = tree[best].g;
+                for (int slot = best; slot != -1; slot = tree[slot].parent) result.path.push_back(tree[slot].node);
+                reverse(result.path.begin(), result.path.end());
+                return true;
+            }
+
+            SmaNode& current = tree[best];
+            int end = csr.offsets[current.node + 1];
+            if (current.edge == end && current.forgotten != kInfinity) {
+                // Every successor was generated once and some were dropped: regenerate the missing ones
+                current.edge = csr.offsets[current.node];
+                current.forgotten = kInfinity;
+            }
+
+            int successor = -1, successor_g = 0;
+            while (current.edge < end && successor == -1) {
+                int e = current.edge++;
+                int neighbor = csr.targets[e];
+                int new_g = current.g + csr.costs[e];
+                int known = ws.g(neighbor);
+                SEARCH_STAT_ADD(stats, generated, 1);
+                if (new_g > known || (new_g == known && ws.came_from[neighbor] != current.node)) continue;
+                bool kept = false;
+                for (int c = current.first_child; c != -1 && !kept; c = tree[c].next_sibling) kept = tree[c].node == neighbor && tree[c].g <= new_g;
+                if (kept) continue;
+                successor = neighbor;
+                successor_g = new_g;
+            }
+
+            if (successor == -1) {
+                if (current.forgotten != kInfinity) {
+                    // stays open to regenerate its dropped children once it is the best again
+                    backUp(best);
+                } else if (current.first_child != -1) {
+                    setOpen(best, false);
+                    backUp(best);
+                } else if (current.parent == -1) {
+                    return false;
+                } else {
+                    killLeaf(best);
+                }
+                continue;
+            }
+
+            SEARCH_STAT_ADD(stats, expanded, 1);
+            int f = max(current.f, successor_g + potential(successor, goal));
+            if (tree.size() - free_slots.size() >= capacity) {
+                // Drop the shallowest leaf with the highest f, never the node being expanded
+                int victim = -1;
+                for (auto it = open.rbegin(); it != open.rend() && victim == -1; ++it) {
+                    int slot = get<2>(*it);
+                    if (slot != best && tree[slot].parent != -1 && tree[slot].first_child == -1) victim = slot;
+                }
+                if (victim == -1) {
+                    // The budget holds only the path to this node, so it cannot be extended
+                    if (tree[best].parent == -1) return false;
+                    killLeaf(best);
+                    continue;
                 }
+                removeLeaf(victim);
             }
+            ws.relax(successor, successor_g, tree[best].node);
+            newNode(successor, best, successor_g, f, tree[best].depth + 1);
+            if (tree[best].edge == end) backUp(best);
         }
-        cout << "Goal not reachable" << endl;
+        return false;
+    }
+
+    // ------------------------ Bidirectional A* Search ------------------------
+    // Forward and backward A* with the symmetric potentials pf(v) = (h_goal(v) - h_start(v)) / 2 and
+    // pb = -pf, which keep both searches consistent. Keys are doubled to stay integral, so a forward
+    // key is 2g + phi(v) and a backward key 2g - phi(v). The search stops once the two smallest keys
+    // sum to at least twice the best meeting cost mu. h comes from the ALT landmarks; without them
+    // phi is 0 and this is bidirectional Dijkstra.
+    void bidirectionalAStarSearch(const string& start, const string& goal, bool two_threads = false) {
+        PathResult result = bidirectionalAStarQuery(start, goal, two_threads);
+        if (!result.found) {
+            cout << "Goal not reachable" << endl;
+            return;
+        }
+        cout << "Bidirectional A* Search Path: ";
+        printPath(result.path);
+    }
+
+    PathResult bidirectionalAStarQuery(const string& start, const string& goal, bool two_threads = false,
+                                       SearchStats* stats = nullptr) {
+        freeze();
+        PathResult result;
+        int s = nodeId(start), t = nodeId(goal);
+        if (s >= 0 && t >= 0) bidirectionalAStarQuery(s, t, result, two_threads, stats);
+        return result;
+    }
+
+    bool bidirectionalAStarQuery(int start, int goal, PathResult& result, bool two_threads = false,
+                                 SearchStats* stats = nullptr) const {
+        result.found = false;
+        result.cost = 0;
+        result.path.clear();
+        if (!connected(start, goal)) return false;
+        if (start == goal) {
+            result.found = true;
+            result.path.push_back(start);
+            return true;
+        }
+        return two_threads ? concurrentBidirectionalAStar(start, goal, result, stats)
+                           : sequentialBidirectionalAStar(start, goal, result, stats);
     }
 
     // ------------------------ AO* Search ------------------------
+    // The children of a node form its connectors: all is_and children together make one AND
+    // connector, and every OR child is a connector of its own. A connector costs the sum of
+    // (1 + child cost); the goal is a solved leaf and any other leaf is unsolvable.
     void aoStarSearch(const string& start, const string& goal) {
-        // priority_queue with pair<cost, node>, min-heap
-        priority_queue<pair<int, string>, vector<pair<int, string>>, greater<pair<int, string>>> open_set;
-        open_set.push({0, start});
+        AOSolution solution = aoStarQuery(start, goal);
+        if (!solution.solved) {
+            cout << "Goal not reachable" << endl;
+            return;
+        }
+        cout << "AO* Solution Graph (cost " << solution.cost << "):" << endl;
+        for (const auto& step : solution.plan) {
+            if (step.second.empty()) continue;
+            cout << nodeName(step.first) << " -> ";
+            for (size_t i = 0; i < step.second.size(); ++i) {
+                cout << nodeName(step.second[i]);
+                if (i != step.second.size() - 1) cout << " + ";
+            }
+            cout << endl;
+        }
+    }
 
-        unordered_map<string, int> best_cost;
-        best_cost[start] = 0;
+    AOSolution aoStarQuery(const string& start, const string& goal, SearchStats* stats = nullptr) {
+        freeze();
+        AOSolution solution;
+        int s = nodeId(start), t = nodeId(goal);
+        if (s >= 0 && t >= 0) aoStarQuery(s, t, solution, stats);
+        return solution;
+    }
+
+    // Batch form: path holds the solution graph's nodes in depth-first order from start
+    bool aoStarQuery(int start, int goal, PathResult& result, SearchStats* stats = nullptr) const {
+        AOSolution solution;
+        aoStarQuery(start, goal, solution, stats);
+        result.found = solution.solved;
+        result.cost = solution.solved ? solution.cost : 0;
+        result.path.clear();
+        for (const auto& step : solution.plan) result.path.push_back(step.first);
+        return result.found;
+    }
 
-        unordered_map<string, string> node_parent;
-        node_parent[start] = "";
+    // AO*: repeatedly expand an unexpanded tip of the best partial solution graph, then revise
+    // costs and SOLVED labels bottom-up through the ancestors of the expanded node. The frontier
+    // in the stats is the explicit graph (every generated node); heap operations are those of
+    // the exact revision on cycles.
+    bool aoStarQuery(int start, int goal, AOSolution& solution, SearchStats* stats = nullptr) const {
+        SEARCH_TIMER(stats, "ao_star");
+        AndOrWorkspace& ws = threadAndOrWorkspace();
+        ws.prepare(nodeCount());
+        solution = AOSolution();
 
-        while (!open_set.empty()) {
-            pair<int, string> top = open_set.top();
-            int cost = top.first;
-            string current = top.second;
-            open_set.pop();
+        generateAndOrNode(ws, start, goal);
+        SEARCH_STAT_ADD(stats, generated, 1);
+        while (!(ws.flags[start] & AndOrWorkspace::Solved) && ws.cost[start] < kFutility) {
+            int tip = findAndOrTip(ws, start);
+            if (tip == -1) break;  // the marked graph only loops back on itself
 
-            if (current == goal) {
-                vector<string> path = reconstructAOPath(node_parent, current);
-                cout << "AO* Search Path: ";
-                for (size_t i = 0; i < path.size(); ++i) {
-                    cout << path[i];
-                if (i != path.size() - 1) cout << " -> ";
+            ws.flags[tip] |= AndOrWorkspace::Expanded;
+            SEARCH_STAT_ADD(stats, expanded, 1);
+            for (int e = csr.and_or_offsets[tip]; e < csr.and_or_offsets[tip + 1]; ++e) {
+                int child = csr.and_or_children[e];
+                if (!ws.generated(child)) {
+                    generateAndOrNode(ws, child, goal);
+                    SEARCH_STAT_ADD(stats, generated, 1);
+                }
+                ws.addParent(child, tip);
             }
-            cout << endl;
+            SEARCH_STAT_MAX(stats, peak_frontier, ws.touched.size());
+            reviseAndOrCosts(ws, tip, stats);
+        }
+        SEARCH_STAT_MAX(stats, peak_memory, ws.memoryBytes());
+
+        if (!(ws.flags[start] & AndOrWorkspace::Solved)) return false;
+        solution.solved = true;
+        solution.cost = ws.cost[start];
+        collectAndOrPlan(ws, start, goal, solution);
+        rememberSolvedNodes(ws, goal);
+        return true;
+    }
+
+    // Forget every memoized AO* subproblem
+    void clearAndOrMemo() {
+        and_or_memo.clear();
+    }
+
+    // ------------------------ Contraction Hierarchies ------------------------
+    // Offline preprocessing: contract nodes in order of edge difference (lazily updated), adding a
+    // shortcut u-w through v whenever a bounded witness search finds no path u-w avoiding v that
+    // is at least as short. Queries then only need to search upward from both endpoints.
+    void buildContractionHierarchy(int witness_settle_limit = 100) {
+        freeze();
+        int n = nodeCount();
+        ch = ContractionHierarchy();
+        ch.rank.assign(n, -1);
+
+        // Working adjacency with parallel edges collapsed to the cheapest one
+        vector<vector<ChEdge>> adj(n);
+        for (int v = 0; v < n; ++v) {
+            for (int e = csr.offsets[v]; e < csr.offsets[v + 1]; ++e) {
+                if (csr.targets[e] != v) addOrImproveEdge(adj[v], csr.targets[e], csr.costs[e], -1);
+            }
+        }
+
+        vector<int> contracted_neighbors(n, 0);
+        vector<int> level(n, 0);
+        vector<vector<ChEdge>> upward(n);
+        SearchWorkspace witness;
+        vector<ChShortcut> shortcuts;
+        // Priorities only need an estimate, so they use a much cheaper witness search than contraction
+        int estimate_limit = max(1, witness_settle_limit / 10);
+
+        // Queue entries whose priority no longer matches current_priority are stale and skipped
+        using Entry = pair<int, int>;  // (priority, node)
+        priority_queue<Entry, vector<Entry>, greater<Entry>> order;
+        vector<int> current_priority(n);
+        for (int v = 0; v < n; ++v) {
+            current_priority[v] = simulateContraction(v, adj, contracted_neighbors, level, witness, estimate_limit, shortcuts);
+            order.push({current_priority[v], v});
+        }
+
+        int next_rank = 0;
+        while (!order.empty()) {
+            int v = order.top().second;
+            int queued = order.top().first;
+            order.pop();
+            if (ch.rank[v] != -1 || queued != current_priority[v]) continue;
+
+            // Lazy update: re-evaluate and only contract if v is still the cheapest choice
+            int priority = simulateContraction(v, adj, contracted_neighbors, level, witness, estimate_limit, shortcuts);
+            if (priority > queued && !order.empty() && priority > order.top().first) {
+                current_priority[v] = priority;
+                order.push({priority, v});
+                continue;
+            }
+            simulateContraction(v, adj, contracted_neighbors, level, witness, witness_settle_limit, shortcuts);
+
+            for (const ChShortcut& shortcut : shortcuts) {
+                addOrImproveEdge(adj[shortcut.from], shortcut.to, shortcut.cost, v);
+                addOrImproveEdge(adj[shortcut.to], shortcut.from, shortcut.cost, v);
+            }
+            for (const ChEdge& edge : adj[v]) {
+                upward[v].push_back(edge);
+                vector<ChEdge>& back = adj[edge.to];
+                for (size_t i = 0; i < back.size(); ++i) {
+                    if (back[i].to == v) {
+                        back[i] = back.back();
+                        back.pop_back();
+                        break;
+                    }
+                }
+                ++contracted_neighbors[edge.to];
+                level[edge.to] = max(level[edge.to], level[v] + 1);
+            }
+            vector<ChEdge>().swap(adj[v]);
+            ch.rank[v] = next_rank++;
+
+            // Neighbors' priorities changed the most; refresh them now instead of waiting for a pop
+            for (const ChEdge& edge : upward[v]) {
+                int priority = simulateContraction(edge.to, adj, contracted_neighbors, level, witness, estimate_limit, shortcuts);
+                if (priority != current_priority[edge.to]) {
+                    current_priority[edge.to] = priority;
+                    order.push({priority, edge.to});
+                }
+            }
+        }
+
+        ch.up_offsets.assign(n + 1, 0);
+        for (int v = 0; v < n; ++v) ch.up_offsets[v + 1] = ch.up_offsets[v] + static_cast<int>(upward[v].size());
+        ch.up_targets.resize(ch.up_offsets[n]);
+        ch.up_costs.resize(ch.up_offsets[n]);
+        ch.up_middle.resize(ch.up_offsets[n]);
+        for (int v = 0; v < n; ++v) {
+            int e = ch.up_offsets[v];
+            for (const ChEdge& edge : upward[v]) {
+                ch.up_targets[e] = edge.to;
+                ch.up_costs[e] = edge.cost;
+                ch.up_middle[e] = edge.middle;
+                ++e;
+            }
+        }
+    }
+
+    bool hasContractionHierarchy() const {
+        return !ch.rank.empty();
+    }
+
+    void contractionHierarchySearch(const string& start, const string& goal) {
+        PathResult result = contractionHierarchyQuery(start, goal);
+        if (!result.found) {
+            cout << "Goal not reachable" << endl;
             return;
         }
+        cout << "CH Search Path: ";
+        printPath(result.path);
+    }
 
-            for (const auto& neighbor : and_or_graph[current]) {
-                const string& child = neighbor.first;
-                bool is_and = neighbor.second;
-                // For both AND and OR nodes, update if better cost found
-                if (best_cost.find(child) == best_cost.end() || cost + 1 < best_cost[child]) {
-                    best_cost[child] = cost + 1;
-                    open_set.push({cost + 1, child});
-                    node_parent[child] = current;
+    PathResult contractionHierarchyQuery(const string& start, const string& goal, SearchStats* stats = nullptr) {
+        freeze();
+        if (!hasContractionHierarchy()) buildContractionHierarchy();
+        PathResult result;
+        int s = nodeId(start), t = nodeId(goal);
+        if (s >= 0 && t >= 0) contractionHierarchyQuery(s, t, result, stats);
+        return result;
+    }
+
+    // Bidirectional Dijkstra restricted to upward edges; the shortest path meets at its highest-
+    // ranked node. Shortcuts on the result are unpacked back into original edges.
+    bool contractionHierarchyQuery(int start, int goal, PathResult& result, SearchStats* stats = nullptr) const {
+        SEARCH_TIMER(stats, "contraction_hierarchy");
+        SearchWorkspace& forward = threadWorkspace(0);
+        SearchWorkspace& backward = threadWorkspace(1);
+        forward.prepare(nodeCount());
+        backward.prepare(nodeCount());
+        SEARCH_STAT_MAX(stats, peak_memory, forward.memoryBytes() + backward.memoryBytes());
+        result.found = false;
+        result.cost = 0;
+        result.path.clear();
+        if (!connected(start, goal)) return false;
+
+        forward.relax(start, 0, -1);
+        forward.open_set.pushOrDecrease(start, 0);
+        backward.relax(goal, 0, -1);
+        backward.open_set.pushOrDecrease(goal, 0);
+        SEARCH_STAT_ADD(stats, pushes, 2);
+
+        int best = kInfinity, meeting = -1;
+        bool forward_turn = true;
+        while (true) {
+            bool forward_live = !forward.open_set.empty() && forward.open_set.topKey() < best;
+            bool backward_live = !backward.open_set.empty() && backward.open_set.topKey() < best;
+            if (!forward_live && !backward_live) break;
+            if (!forward_live) forward_turn = false;
+            if (!backward_live) forward_turn = true;
+
+            SearchWorkspace& self = forward_turn ? forward : backward;
+            const SearchWorkspace& other = forward_turn ? backward : forward;
+            forward_turn = !forward_turn;
+
+            SEARCH_STAT_MAX(stats, peak_frontier, forward.open_set.size() + backward.open_set.size());
+            int u = self.open_set.pop();
+            int g = self.g_cost[u];
+            int other_g = other.g(u);
+            SEARCH_STAT_ADD(stats, pops, 1);
+            SEARCH_STAT_ADD(stats, expanded, 1);
+            SEARCH_STAT_ADD(stats, generated, ch.up_offsets[u + 1] - ch.up_offsets[u]);
+            if (other_g != kInfinity && g + other_g < best) {
+                best = g + other_g;
+                meeting = u;
+            }
+            for (int e = ch.up_offsets[u]; e < ch.up_offsets[u + 1]; ++e) {
+                int v = ch.up_targets[e];
+                int new_g = g + ch.up_costs[e];
+                if (new_g < self.g(v)) {
+                    self.relax(v, new_g, u);
+                    self.open_set.pushOrDecrease(v, new_g);
+                    SEARCH_STAT_ADD(stats, pushes, 1);
                 }
             }
         }
-        cout << "Goal not reachable" << endl;
+        if (meeting == -1) return false;
+
+        // Queue the hierarchy hops so the first hop from start is on top of the stack:
+        // meeting -> goal hops go in reversed, start -> meeting hops are found last-first
+        vector<pair<int, int>>& stack = forward.unpack_stack;
+        stack.clear();
+        for (int v = meeting; backward.came_from[v] != -1; v = backward.came_from[v]) {
+            stack.push_back({v, backward.came_from[v]});
+        }
+        reverse(stack.begin(), stack.end());
+        for (int v = meeting; forward.came_from[v] != -1; v = forward.came_from[v]) {
+            stack.push_back({forward.came_from[v], v});
+        }
+
+        result.found = true;
+        result.cost = best;
+        result.path.push_back(start);
+        while (!stack.empty()) {
+            pair<int, int> hop = stack.back();
+            stack.pop_back();
+            int middle = shortcutMiddle(hop.first, hop.second);
+            if (middle == -1) {
+                result.path.push_back(hop.second);
+            } else {
+                stack.push_back({middle, hop.second});
+                stack.push_back({hop.first, middle});
+            }
+        }
+        return true;
+    }
+
+    // ------------------------ Batch Search ------------------------
+    // Answer independent queries in parallel over the frozen graph; results[i] answers queries[i]
+    vector<PathResult> batchSearch(const PathQuery* queries, size_t count, SearchMode mode, WorkStealingPool& pool) {
+        freeze();
+        if (mode == SearchMode::ContractionHierarchy && !hasContractionHierarchy()) buildContractionHierarchy();
+        vector<PathResult> results(count);
+        const InformedGraph& snapshot = *this;
+        int n = nodeCount();
+        pool.parallelFor(count, [&](size_t i) {
+            int s = queries[i].start, t = queries[i].goal;
+            if (s < 0 || t < 0 || s >= n || t >= n) return;
+            switch (mode) {
+                case SearchMode::BestFirst: snapshot.bestFirstQuery(s, t, results[i]); break;
+                case SearchMode::AStar: snapshot.aStarQuery(s, t, results[i]); break;
+                case SearchMode::BidirectionalAStar: snapshot.bidirectionalAStarQuery(s, t, results[i]); break;
+                case SearchMode::IDAStar: snapshot.idaStarQuery(s, t, results[i]); break;
+                case SearchMode::AOStar: snapshot.aoStarQuery(s, t, results[i]); break;
+                case SearchMode::ContractionHierarchy: snapshot.contractionHierarchyQuery(s, t, results[i]); break;
+            }
+        });
+        return results;
+    }
+
+    vector<PathResult> batchSearch(const vector<PathQuery>& queries, SearchMode mode = SearchMode::AStar) {
+        return batchSearch(queries.data(), queries.size(), mode, sharedPool());
+    }
+
+    static WorkStealingPool& sharedPool() {
+        static WorkStealingPool pool;
+        return pool;
     }
 
 private:
-    int getHeuristic(const string& node) {
-        if (heuristics.find(node) != heuristics.end()) {
-            return heuristics[node];
+    bool checkWritable() const {
+        if (isMapped()) {
+            cerr << "Graph is memory-mapped from a binary file and cannot be modified" << endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool rejectBinary(const string& path) const {
+        cerr << "Invalid or incompatible graph file " << path << endl;
+        return false;
+    }
+
+    // Whether the arrays of a mapped file can be used safely: both CSRs and the name offsets are
+    // monotone and end at their header counts, every target and child is a node, no edge cost is
+    // negative (as the text loader requires), and sorted_names lists node ids in strictly
+    // increasing name order
+    static bool validMapping(const CompactGraph& graph, const BinaryGraphHeader& header, WorkStealingPool& pool) {
+        int n = graph.node_count;
+        if (!validCsr(graph.offsets, graph.targets, n, header.edge_slots, pool) ||
+            !validCsr(graph.and_or_offsets, graph.and_or_children, n, header.and_or_count, pool) ||
+            !validCsr(graph.name_offsets, nullptr, n, header.name_bytes, pool)) {
+            return false;
         }
-        return numeric_limits<int>::max();
+        auto name = [&](int id) {
+            return string_view(graph.names + graph.name_offsets[id], graph.name_offsets[id + 1] - graph.name_offsets[id]);
+        };
+        atomic<bool> valid{true};
+        size_t slots = static_cast<size_t>(header.edge_slots);
+        pool.parallelFor((slots + kLoadVertexBlock - 1) / kLoadVertexBlock, [&](size_t block) {
+            size_t last = min(slots, (block + 1) * kLoadVertexBlock);
+            for (size_t e = block * kLoadVertexBlock; e < last; ++e) {
+                if (graph.costs[e] < 0) {
+                    valid.store(false, memory_order_relaxed);
+                    return;
+                }
+            }
+        });
+        pool.parallelFor((static_cast<size_t>(n) + kLoadVertexBlock - 1) / kLoadVertexBlock, [&](size_t block) {
+            size_t last = min<size_t>(n, (block + 1) * kLoadVertexBlock);
+            for (size_t i = block * kLoadVertexBlock; i < last; ++i) {
+                int id = graph.sorted_names[i];
+                if (id < 0 || id >= n || (i > 0 && (graph.sorted_names[i - 1] < 0 || graph.sorted_names[i - 1] >= n ||
+                                                    name(graph.sorted_names[i - 1]) >= name(id)))) {
+                    valid.store(false, memory_order_relaxed);
+                    return;
+                }
+            }
+        });
+        return valid.load();
     }
 
-    vector<string> reconstructPath(unordered_map<string, string>& came_from, string current) {
-        vector<string> path;
-        path.push_back(current);
-        while (came_from.find(current) != came_from.end()) {
-            current = came_from[current];
-            path.push_back(current);
+    // Parse the edges starting in [begin, end) into chunk; on a malformed line, an extra column or a
+    // negative cost (the searches assume costs are non-negative), record its offset and stop
+    static void parseEdgeChunk(const char* data, size_t begin, size_t end, EdgeChunk& chunk) {
+        chunk.endpoints.reserve((end - begin) / 6);
+        chunk.costs.reserve((end - begin) / 12);
+        forEachDataLine(data, begin, end, [&](const char* line, const char* line_end) {
+            const char* p = line;
+            skipSeparators(p, line_end);
+            char first = *p;
+            int u, v, cost = 1;
+            bool valid = parseInt(p, line_end, u);
+            if (valid) {
+                skipSeparators(p, line_end);
+                valid = parseInt(p, line_end, v);
+            }
+            if (valid) {
+                skipSeparators(p, line_end);
+                if (p < line_end) valid = parseInt(p, line_end, cost);
+                skipSeparators(p, line_end);
+                valid = valid && p == line_end;
+            }
+            if (!valid) {
+                if (line == data && static_cast<unsigned>(first - '0') >= 10 && first != '-' && first != '+') return true;
+                chunk.error = static_cast<size_t>(line - data);
+                chunk.error_reason = "Malformed edge";
+                return false;
+            }
+            if (cost < 0) {
+                chunk.error = static_cast<size_t>(line - data);
+                chunk.error_reason = "Negative edge cost";
+                return false;
+            }
+            chunk.endpoints.push_back(u);
+            chunk.endpoints.push_back(v);
+            chunk.costs.push_back(cost);
+            chunk.low = min(chunk.low, min(u, v));
+            chunk.high = max(chunk.high, max(u, v));
+            return true;
+        });
+    }
+
+    // Rebuild the component index from the frozen CSR in the Afforest style: link every node to
+    // its first two neighbors, find the component most nodes already fall in by sampling, and only
+    // walk the remaining edges of nodes outside it. Every edge out of the big component is still
+    // seen from its other endpoint, so the result is exact.
+    void indexComponents(WorkStealingPool& pool) {
+        components.clear();
+        int n = csr.node_count;
+        if (n == 0) return;
+        size_t blocks = (static_cast<size_t>(n) + kLoadVertexBlock - 1) / kLoadVertexBlock;
+        auto forEachNode = [&](const function<void(int)>& body) {
+            pool.parallelFor(blocks, [&](size_t block) {
+                int last = static_cast<int>(min<size_t>(n, (block + 1) * kLoadVertexBlock));
+                for (int v = static_cast<int>(block * kLoadVertexBlock); v < last; ++v) body(v);
+            });
+        };
+        constexpr int kNeighborRounds = 2;
+        forEachNode([&](int v) {
+            for (int e = csr.offsets[v]; e < min(csr.offsets[v + 1], csr.offsets[v] + kNeighborRounds); ++e) {
+                components.unite(v, csr.targets[e]);
+            }
+        });
+
+        unordered_map<int, int> votes;
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        for (int i = 0; i < 1024; ++i) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            ++votes[components.find(static_cast<int>(state % n))];
         }
-        reverse(path.begin(), path.end());
-        return path;
+        int largest = max_element(votes.begin(), votes.end(), [](const pair<const int, int>& a, const pair<const int, int>& b) {
+            return a.second < b.second;
+        })->first;
+
+        forEachNode([&](int v) {
+            if (components.find(v) == largest) return;
+            for (int e = csr.offsets[v] + kNeighborRounds; e < csr.offsets[v + 1]; ++e) components.unite(v, csr.targets[e]);
+        });
     }
 
-    vector<string> reconstructAOPath(unordered_map<string, string>& node_parent, string current) {
-        vector<string> path;
-        path.push_back(current);
-        while (node_parent.find(current) != node_parent.end() && !node_parent[current].empty()) {
-            current = node_parent[current];
-            path.push_back(current);
+    static uint64_t alignTo8(uint64_t position) {
+        return (position + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    static void padTo(ofstream& out, uint64_t position) {
+        static const char zeros[8] = {};
+        uint64_t current = static_cast<uint64_t>(out.tellp());
+        if (position > current) out.write(zeros, position - current);
+    }
+
+    int internNode(const string& name) {
+        auto it = node_ids.find(name);
+        if (it != node_ids.end()) return it->second;
+        int id = nodeCount();
+        node_ids.emplace(name, id);
+        node_names.push_back(name);
+        csr.heuristic_store.push_back(kNoHeuristic);
+        frozen = false;
+        return id;
+    }
+
+    int getHeuristic(int node) const {
+        return csr.heuristics[node];
+    }
+
+    // Heuristic used by A*: the ALT bound when landmarks are available, otherwise the
+    // manual h(n) with unset nodes counted as 0 so f = g + h cannot overflow
+    int potential(int node, int goal) const {
+        if (landmarks.empty()) return csr.heuristics[node] == kNoHeuristic ? 0 : csr.heuristics[node];
+        return landmarkBound(node, goal);
+    }
+
+    // ALT lower bound on d(node, goal); 0 without landmarks
+    int landmarkBound(int node, int goal) const {
+        size_t k = landmarks.size();
+        const int* from_node = &landmark_dist[node * k];
+        const int* from_goal = &landmark_dist[goal * k];
+        int best = 0;
+        for (size_t i = 0; i < k; ++i) {
+            if (from_node[i] == kInfinity || from_goal[i] == kInfinity) continue;
+            best = max(best, abs(from_goal[i] - from_node[i]));
         }
-        reverse(path.begin(), path.end());
-        return path;
+        return best;
+    }
+
+    // phi(v) = h_goal(v) - h_start(v), twice the forward potential
+    int bidirectionalPotential(int v, int start, int goal) const {
+        if (landmarks.empty()) return 0;
+        return landmarkBound(v, goal) - landmarkBound(v, start);
+    }
+
+    bool sequentialBidirectionalAStar(int start, int goal, PathResult& result, SearchStats* stats) const {
+        SEARCH_TIMER(stats, "bidirectional_a_star");
+        SearchWorkspace& forward = threadWorkspace(0);
+        SearchWorkspace& backward = threadWorkspace(1);
+        forward.prepare(nodeCount());
+        backward.prepare(nodeCount());
+        SEARCH_STAT_MAX(stats, peak_memory, forward.memoryBytes() + backward.memoryBytes());
+
+        forward.relax(start, 0, -1);
+        forward.open_set.pushOrDecrease(start, bidirectionalPotential(start, start, goal));
+        backward.relax(goal, 0, -1);
+        backward.open_set.pushOrDecrease(goal, -bidirectionalPotential(goal, start, goal));
+        SEARCH_STAT_ADD(stats, pushes, 2);
+
+        long long best = numeric_limits<long long>::max() / 4;
+        int meeting = -1;
+        // Once either side runs dry everything it can reach is final, so mu is exact
+        while (!forward.open_set.empty() && !backward.open_set.empty()) {
+            long long forward_top = forward.open_set.topKey(), backward_top = backward.open_set.topKey();
+            if (forward_top + backward_top >= 2 * best) break;
+
+            bool go_forward = forward_top <= backward_top;
+            SearchWorkspace& self = go_forward ? forward : backward;
+            const SearchWorkspace& other = go_forward ? backward : forward;
+            int sign = go_forward ? 1 : -1;
+
+            SEARCH_STAT_MAX(stats, peak_frontier, forward.open_set.size() + backward.open_set.size());
+            int u = self.open_set.pop();
+            int g = self.g_cost[u];
+            SEARCH_STAT_ADD(stats, pops, 1);
+            SEARCH_STAT_ADD(stats, expanded, 1);
+            SEARCH_STAT_ADD(stats, generated, csr.offsets[u + 1] - csr.offsets[u]);
+            for (int e = csr.offsets[u]; e < csr.offsets[u + 1]; ++e) {
+                int v = csr.targets[e];
+                int new_g = g + csr.costs[e];
+                if (new_g >= self.g(v)) continue;
+                self.relax(v, new_g, u);
+                self.open_set.pushOrDecrease(v, 2 * new_g + sign * bidirectionalPotential(v, start, goal));
+                SEARCH_STAT_ADD(stats, pushes, 1);
+                int other_g = other.g(v);
+                if (other_g != kInfinity && static_cast<long long>(new_g) + other_g < best) {
+                    best = static_cast<long long>(new_g) + other_g;
+                    meeting = v;
+                }
+            }
+        }
+        if (meeting == -1) return false;
+
+        result.found = true;
+        result.cost = static_cast<int>(best);
+        for (int v = meeting; v != -1; v = forward.came_from[v]) result.path.push_back(v);
+        reverse(result.path.begin(), result.path.end());
+        for (int v = backward.came_from[meeting]; v != -1; v = backward.came_from[v]) result.path.push_back(v);
+        return true;
+    }
+
+    // Each direction runs on its own thread. A thread publishes a label before reading the other
+    // side's label for the same node (both sequentially consistent), so for any node reached from
+    // both sides at least one thread sees the pair and lowers mu with a CAS; no locks are taken.
+    bool concurrentBidirectionalAStar(int start, int goal, PathResult& result, SearchStats* stats) const {
+        SEARCH_TIMER(stats, "bidirectional_a_star_two_threads");
+        ConcurrentBidirectionalWorkspace& ws = threadConcurrentWorkspace();
+        ws.prepare(nodeCount());
+        // Each thread counts into its own half; the halves are summed after the join
+        SearchStats side_stats[2];
+
+        auto runSide = [&](int which) {
+            SearchStats* counts = stats ? &side_stats[which] : nullptr;
+            ConcurrentSide& self = ws.side[which];
+            const ConcurrentSide& other = ws.side[1 - which];
+            int sign = which == 0 ? 1 : -1;
+            uint64_t stamp = static_cast<uint64_t>(ws.generation) << 32;
+            const long long unreached = numeric_limits<long long>::max() / 4;
+
+            while (!ws.done.load(memory_order_relaxed)) {
+                if (self.open_set.empty()) {
+                    self.top_key.store(unreached);
+                    ws.done.store(true);
+                    return;
+                }
+                long long top = self.open_set.topKey();
+                self.top_key.store(top);
+                uint64_t best = ws.best.load();
+                long long mu = best == ~0ull ? unreached : static_cast<long long>(best >> 32);
+                if (top + other.top_key.load() >= 2 * mu) {
+                    ws.done.store(true);
+                    return;
+                }
+
+                SEARCH_STAT_MAX(counts, peak_frontier, self.open_set.size());
+                int u = self.open_set.pop();
+                int g = ws.g(which, u);
+                SEARCH_STAT_ADD(counts, pops, 1);
+                SEARCH_STAT_ADD(counts, expanded, 1);
+                SEARCH_STAT_ADD(counts, generated, csr.offsets[u + 1] - csr.offsets[u]);
+                for (int e = csr.offsets[u]; e < csr.offsets[u + 1]; ++e) {
+                    int v = csr.targets[e];
+                    int new_g = g + csr.costs[e];
+                    if (new_g >= ws.g(which, v)) continue;
+                    self.came_from[v] = u;
+                    self.label[v].store(stamp | static_cast<uint32_t>(new_g));
+                    self.open_set.pushOrDecrease(v, 2 * new_g + sign * bidirectionalPotential(v, start, goal));
+                    SEARCH_STAT_ADD(counts, pushes, 1);
+
+                    int other_g = ws.g(1 - which, v);
+                    if (other_g == kInfinity) continue;
+                    uint64_t candidate = (static_cast<uint64_t>(new_g + other_g) << 32) | static_cast<uint32_t>(v);
+                    uint64_t current = ws.best.load();
+                    while (candidate < current && !ws.best.compare_exchange_weak(current, candidate)) {
+                    }
+                }
+            }
+        };
+
+        uint64_t stamp = static_cast<uint64_t>(ws.generation) << 32;
+        ws.side[0].label[start].store(stamp);
+        ws.side[0].came_from[start] = -1;
+        ws.side[0].open_set.pushOrDecrease(start, bidirectionalPotential(start, start, goal));
+        ws.side[0].top_key.store(ws.side[0].open_set.topKey());
+        ws.side[1].label[goal].store(stamp);
+        ws.side[1].came_from[goal] = -1;
+        ws.side[1].open_set.pushOrDecrease(goal, -bidirectionalPotential(goal, start, goal));
+        ws.side[1].top_key.store(ws.side[1].open_set.topKey());
+
+        thread backward([&] { runSide(1); });
+        runSide(0);
+        backward.join();
+#ifdef SEARCH_STATS
+        if (stats) {
+            for (const SearchStats& half : side_stats) {
+                stats->expanded += half.expanded;
+                stats->generated += half.generated;
+                stats->pushes += half.pushes + 1;
+                stats->pops += half.pops;
+                stats->peak_frontier += half.peak_frontier;
+            }
+            size_t label_bytes = 2 * ws.side[0].capacity * (sizeof(atomic<uint64_t>) + sizeof(int));
+            stats->peak_memory = max(stats->peak_memory, label_bytes + ws.side[0].open_set.memoryBytes() +
+                                                             ws.side[1].open_set.memoryBytes());
+        }
+#endif
+
+        uint64_t best = ws.best.load();
+        if (best == ~0ull) return false;
+        int meeting = static_cast<int>(best & 0xffffffffu);
+        result.found = true;
+        result.cost = static_cast<int>(best >> 32);
+        for (int v = meeting; v != -1; v = ws.side[0].came_from[v]) result.path.push_back(v);
+        reverse(result.path.begin(), result.path.end());
+        for (int v = ws.side[1].came_from[meeting]; v != -1; v = ws.side[1].came_from[v]) result.path.push_back(v);
+        return true;
+    }
+
+    // Initial AO* label: goal and memoized nodes are solved, other leaves are unsolvable,
+    // everything else starts at its heuristic estimate
+    void generateAndOrNode(AndOrWorkspace& ws, int v, int goal) const {
+        ws.generate(v);
+        if (v == goal) {
+            ws.cost[v] = 0;
+            ws.flags[v] |= AndOrWorkspace::Solved | AndOrWorkspace::Expanded;
+            return;
+        }
+        {
+            shared_lock<shared_mutex> guard(and_or_memo.lock);
+            auto it = and_or_memo.solved.find(andOrMemoKey(goal, v));
+            if (it != and_or_memo.solved.end()) {
+                ws.cost[v] = it->second.cost;
+                ws.connector[v] = it->second.connector;
+                ws.flags[v] |= AndOrWorkspace::Solved | AndOrWorkspace::Expanded | AndOrWorkspace::FromMemo;
+                return;
+            }
+        }
+        if (csr.and_or_offsets[v] == csr.and_or_offsets[v + 1]) {
+            ws.cost[v] = kFutility;
+            ws.flags[v] |= AndOrWorkspace::Expanded;
+            return;
+        }
+        ws.cost[v] = csr.heuristics[v] == kNoHeuristic ? 0 : min(csr.heuristics[v], kFutility);
+    }
+
+    // Depth-first walk of the marked connectors from start; returns an unexpanded node or -1
+    int findAndOrTip(AndOrWorkspace& ws, int start) const {
+        ws.newVisit();
+        ws.stack.clear();
+        ws.stack.push_back(start);
+        ws.visit[start] = ws.visit_generation;
+        while (!ws.stack.empty()) {
+            int u = ws.stack.back();
+            ws.stack.pop_back();
+            if (ws.flags[u] & AndOrWorkspace::Solved) continue;
+            if (!(ws.flags[u] & AndOrWorkspace::Expanded)) return u;
+            for (int e = csr.and_or_offsets[u]; e < csr.and_or_offsets[u + 1]; ++e) {
+                if (!inConnectorOf(ws.connector[u], e)) continue;
+                int child = csr.and_or_children[e];
+                if (ws.visit[child] != ws.visit_generation) {
+                    ws.visit[child] = ws.visit_generation;
+                    ws.stack.push_back(child);
+                }
+            }
+        }
+        return -1;
+    }
+
+    bool inConnectorOf(int connector, int e) const {
+        return connector == kAndConnector ? csr.and_or_is_and[e] != 0 : connector == e;
+    }
+
+    // Best connector of u from its children's current labels; Pending children count as unsolvable
+    void evaluateAndOrNode(const AndOrWorkspace& ws, int u, int& best_cost, int& best_connector, bool& best_solved) const {
+        best_cost = kFutility;
+        best_connector = kNoConnector;
+        best_solved = false;
+        long long and_cost = 0;
+        bool and_solved = true, has_and = false;
+        for (int e = csr.and_or_offsets[u]; e < csr.and_or_offsets[u + 1]; ++e) {
+            int child = csr.and_or_children[e];
+            bool pending = (ws.flags[child] & AndOrWorkspace::Pending) != 0;
+            int child_cost = pending ? kFutility : ws.cost[child];
+            bool child_solved = !pending && (ws.flags[child] & AndOrWorkspace::Solved) != 0;
+            if (csr.and_or_is_and[e]) {
+                has_and = true;
+                and_cost += 1 + child_cost;
+                and_solved = and_solved && child_solved;
+                continue;
+            }
+            int option = min(1 + child_cost, kFutility);
+            if (option < best_cost || (option == best_cost && child_solved && !best_solved)) {
+                best_cost = option;
+                best_connector = e;
+                best_solved = child_solved;
+            }
+        }
+        if (has_and) {
+            int option = static_cast<int>(min<long long>(and_cost, kFutility));
+            if (option < best_cost || (option == best_cost && and_solved && !best_solved)) {
+                best_cost = option;
+                best_connector = kAndConnector;
+                best_solved = and_solved;
+            }
+        }
+        if (best_cost >= kFutility) best_solved = false;
+    }
+
+    // Re-evaluate the changed node and its ancestors until labels stop changing. On a cycle the
+    // costs would only creep upwards one lap at a time, so after a budget of steps the affected
+    // ancestors are recomputed exactly instead.
+    void reviseAndOrCosts(AndOrWorkspace& ws, int changed, SearchStats* stats) const {
+        vector<int>& pending = ws.stack;
+        pending.clear();
+        pending.push_back(changed);
+        size_t budget = 4 * ws.touched.size() + 64;
+        while (!pending.empty()) {
+            if (budget-- == 0) {
+                recomputeAndOrAncestors(ws, changed, stats);
+                return;
+            }
+            int u = pending.back();
+            pending.pop_back();
+            if (!(ws.flags[u] & AndOrWorkspace::Expanded) || (ws.flags[u] & AndOrWorkspace::FromMemo)) continue;
+
+            int best_cost, best_connector;
+            bool best_solved;
+            evaluateAndOrNode(ws, u, best_cost, best_connector, best_solved);
+            bool was_solved = (ws.flags[u] & AndOrWorkspace::Solved) != 0;
+            if (best_cost == ws.cost[u] && best_solved == was_solved && best_connector == ws.connector[u]) continue;
+            ws.cost[u] = best_cost;
+            ws.connector[u] = best_connector;
+            if (best_solved) ws.flags[u] |= AndOrWorkspace::Solved;
+            for (int p = ws.parent_head[u]; p != -1; p = ws.parent_next[p]) pending.push_back(ws.parent_node[p]);
+        }
+    }
+
+    // Exact revision for cyclic graphs (Knuth's generalization of Dijkstra): every unsolved expanded
+    // ancestor of the changed node is reset, then nodes are finalized cheapest first, each using only
+    // children that are already final. Whatever is left depends on a cycle and is unsolvable.
+    void recomputeAndOrAncestors(AndOrWorkspace& ws, int changed, SearchStats* stats) const {
+        ws.newVisit();
+        ws.zone.clear();
+        vector<int>& stack = ws.stack;
+        stack.clear();
+        stack.push_back(changed);
+        ws.visit[changed] = ws.visit_generation;
+        while (!stack.empty()) {
+            int u = stack.back();
+            stack.pop_back();
+            if (!(ws.flags[u] & AndOrWorkspace::Expanded) || (ws.flags[u] & AndOrWorkspace::Solved)) continue;
+            ws.zone.push_back(u);
+            ws.flags[u] |= AndOrWorkspace::Pending;
+            for (int p = ws.parent_head[u]; p != -1; p = ws.parent_next[p]) {
+                int parent = ws.parent_node[p];
+                if (ws.visit[parent] != ws.visit_generation) {
+                    ws.visit[parent] = ws.visit_generation;
+                    stack.push_back(parent);
+                }
+            }
+        }
+
+        ws.queue.clear();
+        for (int u : ws.zone) {
+            int best_cost, best_connector;
+            bool best_solved;
+            evaluateAndOrNode(ws, u, best_cost, best_connector, best_solved);
+            if (best_cost < kFutility) {
+                ws.queue.pushOrDecrease(u, best_cost);
+                SEARCH_STAT_ADD(stats, pushes, 1);
+            }
+        }
+        while (!ws.queue.empty()) {
+            int u = ws.queue.pop();
+            SEARCH_STAT_ADD(stats, pops, 1);
+            int best_cost, best_connector;
+            bool best_solved;
+            evaluateAndOrNode(ws, u, best_cost, best_connector, best_solved);
+            ws.flags[u] &= ~AndOrWorkspace::Pending;
+            ws.cost[u] = best_cost;
+            ws.connector[u] = best_connector;
+            if (best_solved) ws.flags[u] |= AndOrWorkspace::Solved;
+            for (int p = ws.parent_head[u]; p != -1; p = ws.parent_next[p]) {
+                int parent = ws.parent_node[p];
+                if (!(ws.flags[parent] & AndOrWorkspace::Pending)) continue;
+                evaluateAndOrNode(ws, parent, best_cost, best_connector, best_solved);
+                if (best_cost < kFutility) {
+                    ws.queue.pushOrDecrease(parent, best_cost);
+                    SEARCH_STAT_ADD(stats, pushes, 1);
+                }
+            }
+        }
+        for (int u : ws.zone) {
+            if (!(ws.flags[u] & AndOrWorkspace::Pending)) continue;
+            ws.flags[u] &= ~AndOrWorkspace::Pending;
+            ws.cost[u] = kFutility;
+            ws.connector[u] = kNoConnector;
+        }
+    }
+
+    // Walk the marked connectors of the solved graph; memoized nodes continue through the memo
+    void collectAndOrPlan(AndOrWorkspace& ws, int start, int goal, AOSolution& solution) const {
+        ws.newVisit();
+        vector<int> stack = {start};
+        ws.visit[start] = ws.visit_generation;
+        while (!stack.empty()) {
+            int u = stack.back();
+            stack.pop_back();
+            int connector = kNoConnector;
+            if (ws.generated(u)) {
+                connector = ws.connector[u];
+            } else if (u != goal) {
+                shared_lock<shared_mutex> guard(and_or_memo.lock);
+                auto it = and_or_memo.solved.find(andOrMemoKey(goal, u));
+                if (it != and_or_memo.solved.end()) connector = it->second.connector;
+            }
+            vector<int> children;
+            for (int e = csr.and_or_offsets[u]; e < csr.and_or_offsets[u + 1]; ++e) {
+                if (inConnectorOf(connector, e)) children.push_back(csr.and_or_children[e]);
+            }
+            for (auto it = children.rbegin(); it != children.rend(); ++it) {
+                if (ws.visit[*it] != ws.visit_generation) {
+                    ws.visit[*it] = ws.visit_generation;
+                    stack.push_back(*it);
+                }
+            }
+            solution.plan.push_back({u, move(children)});
+        }
+    }
+
+    void rememberSolvedNodes(const AndOrWorkspace& ws, int goal) const {
+        unique_lock<shared_mutex> guard(and_or_memo.lock);
+        for (int v : ws.touched) {
+            if (v == goal || (ws.flags[v] & AndOrWorkspace::FromMemo) || !(ws.flags[v] & AndOrWorkspace::Solved)) continue;
+            and_or_memo.solved.emplace(andOrMemoKey(goal, v), AndOrMemo::Entry{ws.cost[v], ws.connector[v]});
+        }
+    }
+
+    static uint64_t andOrMemoKey(int goal, int node) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(goal)) << 32) | static_cast<uint32_t>(node);
+    }
+
+    // Keep at most one edge per neighbor in the contraction working graph, preferring the cheaper
+    static void addOrImproveEdge(vector<ChEdge>& edges, int to, int cost, int middle) {
+        for (ChEdge& edge : edges) {
+            if (edge.to == to) {
+                if (cost < edge.cost) {
+                    edge.cost = cost;
+                    edge.middle = middle;
+                }
+                return;
+            }
+        }
+        edges.push_back({to, cost, middle});
+    }
+
+    // Collect the shortcuts contracting v would need and return its priority: weighted edge
+    // difference plus contracted neighbors and hierarchy level, which keeps contraction uniform
+    static int simulateContraction(int v, const vector<vector<ChEdge>>& adj, const vector<int>& contracted_neighbors, const vector<int>& level,
+                                   SearchWorkspace& witness, int settle_limit, vector<ChShortcut>& shortcuts) {
+        shortcuts.clear();
+        const vector<ChEdge>& around = adj[v];
+        int max_out = 0;
+        for (const ChEdge& edge : around) max_out = max(max_out, edge.cost);
+
+        for (size_t i = 0; i + 1 < around.size(); ++i) {
+            int u = around[i].to;
+            int limit = around[i].cost + max_out;
+
+            // Bounded Dijkstra from u that never passes through v
+            witness.prepare(static_cast<int>(adj.size()));
+            witness.relax(u, 0, -1);
+            witness.open_set.pushOrDecrease(u, 0);
+            int settled = 0;
+            while (!witness.open_set.empty() && witness.open_set.topKey() <= limit && settled < settle_limit) {
+                int x = witness.open_set.pop();
+                ++settled;
+                for (const ChEdge& edge : adj[x]) {
+                    if (edge.to == v) continue;
+                    int d = witness.g_cost[x] + edge.cost;
+                    if (d < witness.g(edge.to)) {
+                        witness.relax(edge.to, d, x);
+                        witness.open_set.pushOrDecrease(edge.to, d);
+                    }
+                }
+            }
+
+            for (size_t j = i + 1; j < around.size(); ++j) {
+                int via = around[i].cost + around[j].cost;
+                if (witness.g(around[j].to) > via) shortcuts.push_back({u, around[j].to, via});
+            }
+        }
+        return 2 * (static_cast<int>(shortcuts.size()) - static_cast<int>(around.size())) + contracted_neighbors[v] + level[v];
+    }
+
+    // Contracted node bypassed by the hierarchy edge a-b, or -1 if it is an original edge
+    int shortcutMiddle(int a, int b) const {
+        int low = ch.rank[a] < ch.rank[b] ? a : b;
+        int high = low == a ? b : a;
+        int middle = -1, best = kInfinity;
+        for (int e = ch.up_offsets[low]; e < ch.up_offsets[low + 1]; ++e) {
+            if (ch.up_targets[e] == high && ch.up_costs[e] < best) {
+                best = ch.up_costs[e];
+                middle = ch.up_middle[e];
+            }
+        }
+        return middle;
+    }
+
+    // Exact single-source distances over the whole graph; unreachable nodes get kInfinity
+    void dijkstraFrom(int source, vector<int>& dist) const {
+        fill(dist.begin(), dist.end(), kInfinity);
+        IndexedDaryHeap<4> heap;
+        heap.resize(nodeCount());
+        dist[source] = 0;
+        heap.pushOrDecrease(source, 0);
+        while (!heap.empty()) {
+            int u = heap.pop();
+            for (int e = csr.offsets[u]; e < csr.offsets[u + 1]; ++e) {
+                int v = csr.targets[e];
+                int d = dist[u] + csr.costs[e];
+                if (d < dist[v]) {
+                    dist[v] = d;
+                    heap.pushOrDecrease(v, d);
+                }
+            }
+        }
+    }
+
+    static void collectPath(const SearchWorkspace& ws, int goal, PathResult& result) {
+        result.found = true;
+        result.cost = ws.g_cost[goal];
+        for (int v = goal; v != -1; v = ws.came_from[v]) result.path.push_back(v);
+        reverse(result.path.begin(), result.path.end());
+    }
+
+    void printPath(const vector<int>& path) const {
+        for (size_t i = 0; i < path.size(); ++i) {
+            cout << nodeName(path[i]);
+            if (i != path.size() - 1) cout << " -> ";
+        }
+        cout << endl;
     }
 };
 
@@ -224,8 +2445,100 @@ int main() {
     cout << "\n--- A* Search ---" << endl;
     g.aStarSearch("A", "E");
 
+    cout << "\n--- A* Search with ALT Landmarks ---" << endl;
+    g.precomputeLandmarks(2);
+    g.aStarSearch("A", "E");
+
+    cout << "\n--- Bidirectional A* Search ---" << endl;
+    g.bidirectionalAStarSearch("A", "E");
+    g.bidirectionalAStarSearch("A", "E", true);
+
+    cout << "\n--- IDA* Search ---" << endl;
+    g.idaStarSearch("A", "E");
+
+    cout << "\n--- SMA* Search ---" << endl;
+    g.smaStarSearch("A", "E", 4096);
+
+    cout << "\n--- Contraction Hierarchy Search ---" << endl;
+    g.buildContractionHierarchy();
+    g.contractionHierarchySearch("A", "E");
+
     cout << "\n--- AO* Search ---" << endl;
     g.aoStarSearch("A", "E");
 
+    cout << "\n--- Batch A* Search ---" << endl;
+    vector<PathQuery> queries = {
+        {g.nodeId("A"), g.nodeId("E")},
+        {g.nodeId("B"), g.nodeId("C")},
+        {g.nodeId("E"), g.nodeId("A")},
+    };
+    vector<PathResult> results = g.batchSearch(queries);
+    for (size_t i = 0; i < results.size(); ++i) {
+        cout << g.nodeName(queries[i].start) << " to " << g.nodeName(queries[i].goal) << " (cost " << results[i].cost << "): ";
+        for (size_t j = 0; j < results[i].path.size(); ++j) {
+            cout << g.nodeName(results[i].path[j]);
+            if (j != results[i].path.size() - 1) cout << " -> ";
+        }
+        cout << endl;
+    }
+
+    cout << "\n--- Concurrent Batch Callers ---" << endl;
+    // Batches submitted from two threads at once share the pool and must match sequential A*
+    InformedGraph grid;
+    const int side = 30;
+    for (int v = 0; v < side * side; ++v) {
+        if (v % side + 1 < side) grid.addEdge(to_string(v), to_string(v + 1), v * 7 % 9 + 1);
+        if (v + side < side * side) grid.addEdge(to_string(v), to_string(v + side), v * 5 % 9 + 1);
+    }
+    vector<PathQuery> grid_queries;
+    vector<int> expected;
+    for (int i = 0; i < 100; ++i) {
+        string start = to_string(i * 37 % (side * side)), goal = to_string(i * 101 % (side * side));
+        grid_queries.push_back({grid.nodeId(start), grid.nodeId(goal)});
+        expected.push_back(grid.aStarQuery(start, goal).cost);
+    }
+    atomic<int> matching{0};
+    auto submit = [&] {
+        for (int round = 0; round < 10; ++round) {
+            vector<PathResult> answers = grid.batchSearch(grid_queries);
+            for (size_t i = 0; i < answers.size(); ++i) matching += answers[i].found && answers[i].cost == expected[i];
+        }
+    };
+    thread first(submit), second(submit);
+    first.join();
+    second.join();
+    cout << matching << " of " << 2 * 10 * grid_queries.size() << " answers match sequential A*" << endl;
+
+    cout << "\n--- Binary Graph Files ---" << endl;
+    // A mapped copy answers like the original; a file with a negative cost is rejected at open
+    const string binary_path = "informed_demo.igraph";
+    InformedGraph mapped;
+    bool reopened = grid.saveBinary(binary_path) && mapped.openBinary(binary_path);
+    int same_costs = 0;
+    for (const PathQuery& query : grid_queries) {
+        PathResult original, copy;
+        grid.aStarQuery(query.start, query.goal, original);
+        mapped.aStarQuery(query.start, query.goal, copy);
+        same_costs += reopened && original.cost == copy.cost;
+    }
+    cout << "Mapped grid: " << same_costs << " of " << grid_queries.size() << " costs match" << endl;
+    InformedGraph negative;
+    negative.addEdge("a", "b", -3);
+    negative.addEdge("b", "c", 1);
+    InformedGraph rejected;
+    bool opened = negative.saveBinary(binary_path) && rejected.openBinary(binary_path);
+    cout << "Negative edge cost file " << (opened ? "opened" : "rejected") << endl;
+    remove(binary_path.c_str());
+
+#ifdef SEARCH_STATS
+    cout << "\n--- Search Statistics ---" << endl;
+    SearchStats stats;
+    g.aStarQuery("A", "E", &stats);
+    cout << "A*: expanded " << stats.expanded << ", generated " << stats.generated << ", pushes " << stats.pushes
+         << ", pops " << stats.pops << ", peak frontier " << stats.peak_frontier << ", peak memory "
+         << stats.peak_memory << " bytes, " << stats.wall_ns << " ns" << endl;
+    LatencyHistogram::dumpJson(cout);
+#endif
+
     return 0;
 }
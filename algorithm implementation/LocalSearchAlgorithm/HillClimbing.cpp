@@ -2,30 +2,335 @@
 #include <vector>
 #include <functional>
 #include <limits>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include "LocalSearch.hpp"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HILL_CLIMBING_X86_DISPATCH 1
+#elif defined(_MSC_VER) && (defined(__AVX2__) || defined(__AVX512F__))
+#include <immintrin.h>
+#endif
+
+// A proposed change of one coordinate: solution[index] becomes new_value
+using Move = local_search::CoordinateMove;
+
+// Applies move in place if it lowers cost, updating cost. Scores it with delta_cost_function
+// when one is set; otherwise recomputes the full cost and undoes the move if it does not improve.
+inline bool tryMove(std::vector<int>& solution, int& cost, const Move& move,
+                    const std::function<int(const std::vector<int>&)>& cost_function,
+                    const std::function<int(const std::vector<int>&, size_t, int)>& delta_cost_function) {
+    if (delta_cost_function) {
+        int delta = delta_cost_function(solution, move.index, move.new_value);
+        if (delta < 0) {
+            solution[move.index] = move.new_value;
+            cost += delta;
+            return true;
+        }
+        return false;
+    }
+    int old_value = solution[move.index];
+    solution[move.index] = move.new_value;
+    int neighbor_cost = cost_function(solution);
+    if (neighbor_cost < cost) {
+        cost = neighbor_cost;
+        return true;
+    }
+    solution[move.index] = old_value;
+    return false;
+}
+
+// Best ±step move for the separable quadratic cost sum(a[i]*x[i]^2 + b[i]*x[i]).
+// Moving x[i] by s changes the cost by a[i]*(2*x[i]*s + s*s) + b[i]*s, so the whole
+// 2n neighborhood is scored in one pass over x, a and b, eight or sixteen coordinates
+// at a time. Every kernel returns the same move: lowest delta, then lowest index, then -step.
+struct ScoredMove {
+    Move move;
+    int delta;
+};
+
+inline void quadraticStepsScalar(const int* x, const int* a, const int* b, size_t begin, size_t n, int step,
+                                 ScoredMove& best) {
+    for (size_t i = begin; i < n; ++i) {
+        int curvature = a[i] * step * step;
+        int slope = 2 * a[i] * x[i] * step + b[i] * step;
+        int minus = curvature - slope;
+        int plus = curvature + slope;
+        int delta = minus <= plus ? minus : plus;
+        if (delta < best.delta) {
+            best.delta = delta;
+            best.move = Move{i, x[i] + (minus <= plus ? -step : step)};
+        }
+    }
+}
+
+// Lanes keep their own best (delta, index, step); ties across lanes go to the lower index
+inline void mergeLanes(const int* deltas, const int* indices, const int* steps, int lanes, const int* x,
+                       ScoredMove& best) {
+    for (int lane = 0; lane < lanes; ++lane) {
+        size_t index = static_cast<size_t>(static_cast<uint32_t>(indices[lane]));
+        if (deltas[lane] < best.delta || (deltas[lane] == best.delta && index < best.move.index)) {
+            best.delta = deltas[lane];
+            best.move = Move{index, x[index] + steps[lane]};
+        }
+    }
+}
+
+#if defined(HILL_CLIMBING_X86_DISPATCH) || defined(__AVX2__)
+#ifdef HILL_CLIMBING_X86_DISPATCH
+__attribute__((target("avx2")))
+#endif
+inline void quadraticStepsAvx2(const int* x, const int* a, const int* b, size_t n, int step, ScoredMove& best) {
+    size_t vector_end = n & ~size_t(7);
+    if (vector_end > 0) {
+        const __m256i two_step = _mm256_set1_epi32(2 * step);
+        const __m256i step_squared = _mm256_set1_epi32(step * step);
+        const __m256i plus_step = _mm256_set1_epi32(step);
+        const __m256i minus_step = _mm256_set1_epi32(-step);
+        const __m256i lane_stride = _mm256_set1_epi32(8);
+        __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        __m256i best_delta = _mm256_set1_epi32(std::numeric_limits<int>::max());
+        __m256i best_index = _mm256_setzero_si256();
+        __m256i best_step = _mm256_setzero_si256();
+        for (size_t i = 0; i < vector_end; i += 8) {
+            __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+            __m256i av = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i bv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            __m256i curvature = _mm256_mullo_epi32(av, step_squared);
+            __m256i slope = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_mullo_epi32(av, xv), two_step),
+                                             _mm256_mullo_epi32(bv, plus_step));
+            __m256i minus = _mm256_sub_epi32(curvature, slope);
+            __m256i plus = _mm256_add_epi32(curvature, slope);
+            __m256i take_plus = _mm256_cmpgt_epi32(minus, plus);
+            __m256i delta = _mm256_blendv_epi8(minus, plus, take_plus);
+            __m256i moved = _mm256_blendv_epi8(minus_step, plus_step, take_plus);
+            __m256i better = _mm256_cmpgt_epi32(best_delta, delta);
+            best_delta = _mm256_blendv_epi8(best_delta, delta, better);
+            best_index = _mm256_blendv_epi8(best_index, index, better);
+            best_step = _mm256_blendv_epi8(best_step, moved, better);
+            index = _mm256_add_epi32(index, lane_stride);
+        }
+        alignas(32) int deltas[8], indices[8], steps[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(deltas), best_delta);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(indices), best_index);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(steps), best_step);
+        mergeLanes(deltas, indices, steps, 8, x, best);
+    }
+    quadraticStepsScalar(x, a, b, vector_end, n, step, best);
+}
+#endif
+
+#if defined(HILL_CLIMBING_X86_DISPATCH) || defined(__AVX512F__)
+#ifdef HILL_CLIMBING_X86_DISPATCH
+__attribute__((target("avx512f")))
+#endif
+inline void quadraticStepsAvx512(const int* x, const int* a, const int* b, size_t n, int step, ScoredMove& best) {
+    size_t vector_end = n & ~size_t(15);
+    if (vector_end > 0) {
+        const __m512i two_step = _mm512_set1_epi32(2 * step);
+        const __m512i step_squared = _mm512_set1_epi32(step * step);
+        const __m512i plus_step = _mm512_set1_epi32(step);
+        const __m512i minus_step = _mm512_set1_epi32(-step);
+        const __m512i lane_stride = _mm512_set1_epi32(16);
+        __m512i index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        __m512i best_delta = _mm512_set1_epi32(std::numeric_limits<int>::max());
+        __m512i best_index = _mm512_setzero_si512();
+        __m512i best_step = _mm512_setzero_si512();
+        for (size_t i = 0; i < vector_end; i += 16) {
+            __m512i xv = _mm512_loadu_si512(x + i);
+            __m512i av = _mm512_loadu_si512(a + i);
+            __m512i bv = _mm512_loadu_si512(b + i);
+            __m512i curvature = _mm512_mullo_epi32(av, step_squared);
+            __m512i slope = _mm512_add_epi32(_mm512_mullo_epi32(_mm512_mullo_epi32(av, xv), two_step),
+                                             _mm512_mullo_epi32(bv, plus_step));
+            __m512i minus = _mm512_sub_epi32(curvature, slope);
+            __m512i plus = _mm512_add_epi32(curvature, slope);
+            __mmask16 take_plus = _mm512_cmpgt_epi32_mask(minus, plus);
+            __m512i delta = _mm512_mask_blend_epi32(take_plus, minus, plus);
+            __m512i moved = _mm512_mask_blend_epi32(take_plus, minus_step, plus_step);
+            __mmask16 better = _mm512_cmpgt_epi32_mask(best_delta, delta);
+            best_delta = _mm512_mask_blend_epi32(better, best_delta, delta);
+            best_index = _mm512_mask_blend_epi32(better, best_index, index);
+            best_step = _mm512_mask_blend_epi32(better, best_step, moved);
+            index = _mm512_add_epi32(index, lane_stride);
+        }
+        alignas(64) int deltas[16], indices[16], steps[16];
+        _mm512_store_si512(deltas, best_delta);
+        _mm512_store_si512(indices, best_index);
+        _mm512_store_si512(steps, best_step);
+        mergeLanes(deltas, indices, steps, 16, x, best);
+    }
+    quadraticStepsScalar(x, a, b, vector_end, n, step, best);
+}
+#endif
+
+// Picks the widest kernel the CPU supports (checked once at run time under GCC/Clang,
+// fixed at compile time under MSVC). Lane indices are 32-bit, so n must stay below 2^31.
+inline ScoredMove bestQuadraticStep(const std::vector<int>& x, const std::vector<int>& a,
+                                    const std::vector<int>& b, int step) {
+    ScoredMove best{Move{0, 0}, std::numeric_limits<int>::max()};
+#if defined(HILL_CLIMBING_X86_DISPATCH)
+    static const int width = __builtin_cpu_supports("avx512f") ? 16 : __builtin_cpu_supports("avx2") ? 8 : 1;
+    if (width == 16) {
+        quadraticStepsAvx512(x.data(), a.data(), b.data(), x.size(), step, best);
+    } else if (width == 8) {
+        quadraticStepsAvx2(x.data(), a.data(), b.data(), x.size(), step, best);
+    } else {
+        quadraticStepsScalar(x.data(), a.data(), b.data(), 0, x.size(), step, best);
+    }
+#elif defined(__AVX512F__)
+    quadraticStepsAvx512(x.data(), a.data(), b.data(), x.size(), step, best);
+#elif defined(__AVX2__)
+    quadraticStepsAvx2(x.data(), a.data(), b.data(), x.size(), step, best);
+#else
+    quadraticStepsScalar(x.data(), a.data(), b.data(), 0, x.size(), step, best);
+#endif
+    return best;
+}
+
+// Adapters that run HillClimbing's std::function costs through the templated core
+struct FunctionCost {
+    const std::function<int(const std::vector<int>&)>* cost_function;
+
+    int operator()(const std::vector<int>& solution) const {
+        return (*cost_function)(solution);
+    }
+};
+
+struct DeltaFunctionCost : FunctionCost {
+    const std::function<int(const std::vector<int>&, size_t, int)>* delta_cost_function;
+
+    int delta(const std::vector<int>& solution, const Move& move) const {
+        return (*delta_cost_function)(solution, move.index, move.new_value);
+    }
+};
 
 class HillClimbing {
+public:
+    enum class Strategy {
+        FirstImprovement,  // one fixed neighbor per iteration, taken if it improves
+        SteepestAscent,    // best of all ±step neighbors per iteration, stops at a local optimum
+        Annealing          // random ±step neighbor, worse ones taken with probability exp(-delta / T)
+    };
+
 private:
     std::vector<int> current_solution;
     int current_cost;
     int max_iterations;
     std::function<int(const std::vector<int>&)> cost_function;
+    // Optional: cost change if solution[index] became new_value, without applying the move
+    std::function<int(const std::vector<int>&, size_t, int)> delta_cost_function;
+    Strategy strategy;
+    int step_size;
+    // Coefficients of a separable quadratic cost; when set, steepest ascent scores
+    // neighborhoods with the vectorized kernel instead of the cost functions
+    std::vector<int> quadratic_weights;
+    std::vector<int> linear_weights;
+
+    local_search::GeometricCooling cooling;
+    uint64_t seed;
+
+    // Runs the templated core on the current solution, with the delta cost when one is set
+    template <local_search::Strategy core_strategy, typename Neighbor>
+    void search(const Neighbor& neighbor) {
+        if (delta_cost_function) {
+            search<core_strategy>(DeltaFunctionCost{{&cost_function}, &delta_cost_function}, neighbor);
+        } else {
+            search<core_strategy>(FunctionCost{&cost_function}, neighbor);
+        }
+    }
+
+    template <local_search::Strategy core_strategy, typename Cost, typename Neighbor>
+    void search(const Cost& cost, const Neighbor& neighbor) {
+        local_search::LocalSearch<std::vector<int>, Cost, Neighbor, core_strategy> core(cost, neighbor, cooling);
+        core.setInitialSolution(std::move(current_solution), current_cost);
+        core.setMaxIterations(static_cast<size_t>(std::max(0, max_iterations)));
+        core.setSeed(seed);
+        core.run();
+        current_cost = core.getCurrentCost();
+        current_solution = core.releaseSolution();
+    }
 
 public:
-    HillClimbing() : current_cost(std::numeric_limits<int>::max()), max_iterations(1000) {}
+    HillClimbing()
+        : current_cost(std::numeric_limits<int>::max()), max_iterations(1000),
+          strategy(Strategy::FirstImprovement), step_size(1), seed(0) {}
 
+    // The full cost function is needed here, once, for the starting cost
     void setInitialSolution(const std::vector<int>& solution) {
         current_solution = solution;
-        current_cost = cost_function(current_solution);
+        if (cost_function) {
+            current_cost = cost_function(current_solution);
+        }
     }
 
+    // Replaces a separable quadratic cost, including the delta function it installed
     void setCostFunction(const std::function<int(const std::vector<int>&)>& func) {
         cost_function = func;
+        if (!quadratic_weights.empty()) {
+            delta_cost_function = nullptr;
+        }
+        quadratic_weights.clear();
+        linear_weights.clear();
+    }
+
+    // With a delta cost function each step costs O(1) instead of a full recompute
+    void setDeltaCostFunction(const std::function<int(const std::vector<int>&, size_t, int)>& func) {
+        delta_cost_function = func;
+        quadratic_weights.clear();
+        linear_weights.clear();
     }
 
     void setMaxIterations(int max_iter) {
         max_iterations = max_iter;
     }
 
+    void setStrategy(Strategy value) {
+        strategy = value;
+    }
+
+    // Neighbor distance used by steepest ascent and annealing
+    void setStepSize(int step) {
+        step_size = step;
+    }
+
+    void setAnnealingSchedule(double initial_temperature, double alpha) {
+        cooling = local_search::GeometricCooling{initial_temperature, alpha};
+    }
+
+    void setSeed(uint64_t value) {
+        seed = value;
+    }
+
+    // Cost sum(quadratic[i]*x[i]^2 + linear[i]*x[i]), e.g. all-ones and all-zeros for the
+    // sum of squares. Also installs the matching cost and delta functions.
+    void setSeparableQuadraticCost(const std::vector<int>& quadratic, const std::vector<int>& linear) {
+        if (quadratic.size() != linear.size()) {
+            std::cerr << "Quadratic and linear weights differ in length!" << std::endl;
+            return;
+        }
+        quadratic_weights = quadratic;
+        linear_weights = linear;
+        cost_function = [quadratic, linear](const std::vector<int>& solution) {
+            int cost = 0;
+            for (size_t i = 0; i < solution.size(); ++i) {
+                cost += quadratic[i] * solution[i] * solution[i] + linear[i] * solution[i];
+            }
+            return cost;
+        };
+        delta_cost_function = [quadratic, linear](const std::vector<int>& solution, size_t index, int new_value) {
+            int old_value = solution[index];
+            return quadratic[index] * (new_value * new_value - old_value * old_value) +
+                   linear[index] * (new_value - old_value);
+        };
+    }
+
     std::vector<int> getCurrentSolution() const {
         return current_solution;
     }
@@ -39,21 +344,612 @@ public:
             std::cerr << "Cost function not set!" << std::endl;
             return;
         }
-        int iteration = 0;
+        if (current_solution.empty()) {
+            return;
+        }
+
+        if (strategy == Strategy::SteepestAscent) {
+            if (quadratic_weights.empty() || quadratic_weights.size() != current_solution.size()) {
+                search<local_search::Strategy::Steepest>(local_search::CoordinateStep{step_size});
+                return;
+            }
+            for (int iteration = 0; iteration < max_iterations; ++iteration) {
+                ScoredMove best = bestQuadraticStep(current_solution, quadratic_weights, linear_weights, step_size);
+                if (best.delta >= 0) {
+                    break;  // local optimum
+                }
+                current_solution[best.move.index] = best.move.new_value;
+                current_cost += best.delta;
+            }
+        } else if (strategy == Strategy::Annealing) {
+            search<local_search::Strategy::Annealing>(local_search::CoordinateStep{step_size});
+        } else {
+            // Generate a neighbor by modifying one element deterministically; moves are applied in place
+            search<local_search::Strategy::FirstImprovement>(local_search::CyclicDecrement{});
+        }
+    }
+};
+
+// Reusable barrier whose last arriving thread runs a callback before releasing the others
+class RoundBarrier {
+private:
+    std::mutex mutex;
+    std::condition_variable released;
+    size_t parties;
+    size_t waiting;
+    size_t generation;
+
+public:
+    explicit RoundBarrier(size_t count) : parties(count), waiting(0), generation(0) {}
+
+    template <typename Callback>
+    void arrive(Callback&& on_last) {
+        std::unique_lock<std::mutex> lock(mutex);
+        size_t arrived_generation = generation;
+        if (++waiting == parties) {
+            on_last();
+            waiting = 0;
+            ++generation;
+            released.notify_all();
+            return;
+        }
+        released.wait(lock, [&] { return generation != arrived_generation; });
+    }
+};
+
+// Multi-start hill climbing: N independent climbers, each with its own seeded RNG,
+// run on a fixed set of worker threads. Climber i always runs on thread i % threads
+// and draws from a generator seeded by (seed, i) only.
+// Climbers advance in rounds of round_steps moves. The best-so-far is published through
+// an atomic after every round, and the stop checks (target cost, time budget) happen only
+// between rounds. So, without a time budget, the result depends only on the seed and
+// thread count, not on scheduling.
+class RandomRestartHillClimbing {
+public:
+    using NeighborGenerator = std::function<Move(const std::vector<int>&, std::mt19937_64&)>;
+    using RestartGenerator = std::function<std::vector<int>(const std::vector<int>&, std::mt19937_64&)>;
+
+private:
+    struct Climber {
+        std::vector<int> solution;
+        int cost;
+        std::mt19937_64 rng;
+        int steps;
+    };
+
+    std::vector<int> initial_solution;
+    std::function<int(const std::vector<int>&)> cost_function;
+    std::function<int(const std::vector<int>&, size_t, int)> delta_cost_function;
+    NeighborGenerator neighbor_generator;
+    RestartGenerator restart_generator;
+    size_t climber_count;
+    unsigned thread_count;
+    uint64_t seed;
+    int max_iterations;
+    int round_steps;
+    int target_cost;
+    std::chrono::milliseconds time_budget;
+
+    // (order-preserving cost << 32 | climber id), so fetch-min picks the lowest cost and,
+    // among equal costs, the lowest climber id regardless of publication order
+    std::atomic<uint64_t> best_key;
+    std::vector<int> best_solution;
+    bool reached_target;
+
+    static uint64_t packBest(int cost, size_t climber) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cost) ^ 0x80000000u) << 32) | climber;
+    }
+
+    static int unpackCost(uint64_t key) {
+        return static_cast<int>(static_cast<uint32_t>(key >> 32) ^ 0x80000000u);
+    }
+
+    void publishBest(int cost, size_t climber) {
+        uint64_t key = packBest(cost, climber);
+        uint64_t current = best_key.load(std::memory_order_relaxed);
+        while (key < current && !best_key.compare_exchange_weak(current, key, std::memory_order_relaxed)) {
+        }
+    }
+
+    // splitmix64 of (seed, climber), so neighbouring climbers get unrelated streams
+    static uint64_t climberSeed(uint64_t seed, size_t climber) {
+        uint64_t z = seed + 0x9E3779B97F4A7C15ull * (climber + 1);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Default neighbor: one random coordinate moved by +1 or -1
+    static Move randomStep(const std::vector<int>& solution, std::mt19937_64& rng) {
+        size_t index = static_cast<size_t>(rng() % solution.size());
+        int step = (rng() & 1) ? 1 : -1;
+        return Move{index, solution[index] + step};
+    }
+
+public:
+    RandomRestartHillClimbing()
+        : climber_count(8), thread_count(std::max(1u, std::thread::hardware_concurrency())), seed(0),
+          max_iterations(1000), round_steps(256), target_cost(std::numeric_limits<int>::min()),
+          time_budget(std::chrono::milliseconds::zero()), best_key(UINT64_MAX), reached_target(false) {}
+
+    void setInitialSolution(const std::vector<int>& solution) {
+        initial_solution = solution;
+    }
+
+    void setCostFunction(const std::function<int(const std::vector<int>&)>& func) {
+        cost_function = func;
+    }
+
+    void setDeltaCostFunction(const std::function<int(const std::vector<int>&, size_t, int)>& func) {
+        delta_cost_function = func;
+    }
+
+    // Proposes a move for a climber from its current solution and its own RNG
+    void setNeighborGenerator(const NeighborGenerator& generator) {
+        neighbor_generator = generator;
+    }
+
+    // Builds each climber's starting point from the initial solution; by default every
+    // climber starts from the initial solution and diverges through its own random moves
+    void setRestartGenerator(const RestartGenerator& generator) {
+        restart_generator = generator;
+    }
+
+    void setClimbers(size_t count) {
+        climber_count = std::max<size_t>(1, count);
+    }
+
+    void setThreads(unsigned count) {
+        thread_count = std::max(1u, count);
+    }
+
+    void setSeed(uint64_t value) {
+        seed = value;
+    }
+
+    // Moves per climber
+    void setMaxIterations(int max_iter) {
+        max_iterations = max_iter;
+    }
+
+    // Moves per climber between publications and stop checks
+    void setRoundSteps(int steps) {
+        round_steps = std::max(1, steps);
+    }
+
+    // Stop once any climber reaches a cost <= target
+    void setTargetCost(int cost) {
+        target_cost = cost;
+    }
+
+    // Stop after roughly this much wall-clock time; zero disables. Where the run stops then
+    // depends on machine speed, so results under a time budget are not reproducible.
+    void setTimeBudget(std::chrono::milliseconds budget) {
+        time_budget = budget;
+    }
+
+    // Safe to poll from another thread while run() is in progress
+    int getBestCost() const {
+        return unpackCost(best_key.load(std::memory_order_relaxed));
+    }
+
+    size_t getBestClimber() const {
+        return static_cast<size_t>(best_key.load(std::memory_order_relaxed) & 0xFFFFFFFFu);
+    }
+
+    std::vector<int> getBestSolution() const {
+        return best_solution;
+    }
+
+    bool reachedTarget() const {
+        return reached_target;
+    }
+
+    bool run() {
+        if (!cost_function) {
+            std::cerr << "Cost function not set!" << std::endl;
+            return false;
+        }
+        if (initial_solution.empty()) {
+            std::cerr << "Initial solution not set!" << std::endl;
+            return false;
+        }
+
+        best_key.store(UINT64_MAX, std::memory_order_relaxed);
+        best_solution.clear();
+        reached_target = false;
+
+        std::vector<Climber> climbers(climber_count);
+        unsigned threads = static_cast<unsigned>(std::min<size_t>(thread_count, climber_count));
+        auto deadline = std::chrono::steady_clock::now() + time_budget;
+        bool stop = false;
+        RoundBarrier barrier(threads);
+
+        auto worker = [&](unsigned thread) {
+            for (size_t c = thread; c < climber_count; c += threads) {
+                Climber& climber = climbers[c];
+                climber.rng.seed(climberSeed(seed, c));
+                climber.solution = restart_generator ? restart_generator(initial_solution, climber.rng)
+                                                     : initial_solution;
+                climber.cost = cost_function(climber.solution);
+                climber.steps = 0;
+                publishBest(climber.cost, c);
+            }
+
+            // stop is written only by the last thread at the barrier, before the others
+            // are released, so every thread sees the same value after each round
+            for (;;) {
+                barrier.arrive([&] {
+                    int best_cost = getBestCost();
+                    bool all_done = true;
+                    for (const Climber& climber : climbers) {
+                        all_done = all_done && climber.steps >= max_iterations;
+                    }
+                    reached_target = best_cost <= target_cost;
+                    bool out_of_time = time_budget.count() > 0 && std::chrono::steady_clock::now() >= deadline;
+                    stop = all_done || reached_target || out_of_time;
+                });
+                if (stop) {
+                    return;
+                }
+
+                for (size_t c = thread; c < climber_count; c += threads) {
+                    Climber& climber = climbers[c];
+                    if (climber.solution.empty()) {
+                        climber.steps = max_iterations;
+                        continue;
+                    }
+                    int end = std::min(max_iterations, climber.steps + round_steps);
+                    for (; climber.steps < end; ++climber.steps) {
+                        Move move = neighbor_generator ? neighbor_generator(climber.solution, climber.rng)
+                                                       : randomStep(climber.solution, climber.rng);
+                        tryMove(climber.solution, climber.cost, move, cost_function, delta_cost_function);
+                    }
+                    publishBest(climber.cost, c);
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t) {
+            pool.emplace_back(worker, t);
+        }
+        worker(0);
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+
+        best_solution = climbers[getBestClimber()].solution;
+        return true;
+    }
+};
+
+// Local beam search: keeps the k best states in a structure-of-arrays pool, with one
+// contiguous k*n block of coordinates next to the cost and hash arrays. Each iteration
+// replaces the pool with the k best distinct ±step successors of all its states.
+// - Successors are scored in parallel, each thread owning every threads-th state.
+// - Each thread keeps its own top k in a bounded heap, and one thread merges them. When
+//   duplicates among the global top k leave fewer than k distinct states, the merge falls
+//   back to sorting every successor and scans on until the beam is full.
+// - Duplicates are dropped through an open-addressing set of 64-bit state hashes. The hashes
+//   are additive over coordinates, so a successor's hash is updated in O(1) from its parent's.
+//   A hash match is confirmed against the full state, so a collision never drops a state.
+// - Ties are broken by successor id (parent, coordinate, direction), so the result does not
+//   depend on the thread count.
+// Pools, successor arrays and per-thread buffers are sized once at the start of run(),
+// so steady-state iterations do not allocate.
+class LocalBeamSearch {
+private:
+    std::vector<int> initial_solution;
+    std::function<int(const std::vector<int>&)> cost_function;
+    std::function<int(const std::vector<int>&, size_t, int)> delta_cost_function;
+    size_t beam_width;
+    int step_size;
+    int max_iterations;
+    unsigned thread_count;
+
+    std::vector<int> best_solution;
+    int best_cost;
+    int iterations;
+
+    // Current and next generation; state j occupies states[..][j*n, (j+1)*n)
+    std::vector<int> states[2];
+    std::vector<int> costs[2];
+    std::vector<uint64_t> hashes[2];
+    // Cost of successor id = parent*2n + 2*i + (0 for -step, 1 for +step)
+    std::vector<int> successor_costs;
+    // Each thread's copy of the state it is expanding, for the std::function costs
+    std::vector<std::vector<int>> scratch;
+    // Packed (cost, successor id) keys: per-thread top k, then the merged selection; room
+    // for every successor when the top k hold too many duplicates
+    std::vector<uint64_t> candidates;
+    std::vector<size_t> candidate_counts;
+    std::vector<uint64_t> selected;
+    std::vector<uint64_t> selected_hashes;
+    // Open-addressing set over selected: slot j + 1, 0 for empty
+    std::vector<size_t> seen;
+
+    static uint64_t packKey(int cost, uint64_t id) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cost) ^ 0x80000000u) << 32) | id;
+    }
+
+    static int keyCost(uint64_t key) {
+        return static_cast<int>(static_cast<uint32_t>(key >> 32) ^ 0x80000000u);
+    }
+
+    // Hash contribution of coordinate index holding value
+    static uint64_t coordinateHash(size_t index, int value) {
+        uint64_t z = (static_cast<uint64_t>(index) << 32 | static_cast<uint32_t>(value)) + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Whether successor ids a and b of the states in pool are the same state
+    bool sameSuccessor(const std::vector<int>& pool, uint64_t a, uint64_t b) const {
+        size_t n = initial_solution.size();
+        size_t parent_a = static_cast<size_t>(a / (2 * n)), index_a = static_cast<size_t>(a % (2 * n)) / 2;
+        size_t parent_b = static_cast<size_t>(b / (2 * n)), index_b = static_cast<size_t>(b % (2 * n)) / 2;
+        for (size_t i = 0; i < n; ++i) {
+            int value_a = pool[parent_a * n + i];
+            int value_b = pool[parent_b * n + i];
+            if (i == index_a) {
+                value_a += (a & 1) ? step_size : -step_size;
+            }
+            if (i == index_b) {
+                value_b += (b & 1) ? step_size : -step_size;
+            }
+            if (value_a != value_b) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Adds successor key with the given state hash as selected[count] unless an equal state
+    // is already selected; returns whether it was added
+    bool selectDistinct(const std::vector<int>& pool, uint64_t key, uint64_t hash, size_t count) {
+        size_t mask = seen.size() - 1;
+        for (size_t slot = static_cast<size_t>(hash) & mask;; slot = (slot + 1) & mask) {
+            if (seen[slot] == 0) {
+                seen[slot] = count + 1;
+                selected[count] = key;
+                selected_hashes[count] = hash;
+                return true;
+            }
+            size_t other = seen[slot] - 1;
+            if (selected_hashes[other] == hash && sameSuccessor(pool, selected[other] & 0xFFFFFFFFu, key & 0xFFFFFFFFu)) {
+                return false;
+            }
+        }
+    }
+
+    // Scores all 2n successors of state parent into successor_costs and offers them to the
+    // thread's bounded max-heap of its k best keys
+    void expand(size_t parent, const std::vector<int>& pool, int parent_cost, std::vector<int>& solution,
+                uint64_t* heap, size_t& heap_size) {
+        size_t n = initial_solution.size();
+        std::copy(pool.begin() + parent * n, pool.begin() + (parent + 1) * n, solution.begin());
+        for (size_t i = 0; i < n; ++i) {
+            for (int direction = 0; direction < 2; ++direction) {
+                int old_value = solution[i];
+                int new_value = old_value + (direction ? step_size : -step_size);
+                int cost;
+                if (delta_cost_function) {
+                    cost = parent_cost + delta_cost_function(solution, i, new_value);
+                } else {
+                    solution[i] = new_value;
+                    cost = cost_function(solution);
+                    solution[i] = old_value;
+                }
+                uint64_t id = parent * 2 * n + 2 * i + direction;
+                successor_costs[id] = cost;
+                uint64_t key = packKey(cost, id);
+                if (heap_size < beam_width) {
+                    heap[heap_size++] = key;
+                    std::push_heap(heap, heap + heap_size);
+                } else if (key < heap[0]) {
+                    std::pop_heap(heap, heap + heap_size);
+                    heap[heap_size - 1] = key;
+                    std::push_heap(heap, heap + heap_size);
+                }
+            }
+        }
+    }
+
+public:
+    LocalBeamSearch()
+        : beam_width(4), step_size(1), max_iterations(1000),
+          thread_count(std::max(1u, std::thread::hardware_concurrency())),
+          best_cost(std::numeric_limits<int>::max()), iterations(0) {}
+
+    // The beam starts from this one state and fills up from its successors
+    void setInitialSolution(const std::vector<int>& solution) {
+        initial_solution = solution;
+    }
+
+    void setCostFunction(const std::function<int(const std::vector<int>&)>& func) {
+        cost_function = func;
+    }
+
+    void setDeltaCostFunction(const std::function<int(const std::vector<int>&, size_t, int)>& func) {
+        delta_cost_function = func;
+    }
+
+    void setBeamWidth(size_t width) {
+        beam_width = std::max<size_t>(1, width);
+    }
+
+    void setStepSize(int step) {
+        step_size = step;
+    }
+
+    void setMaxIterations(int max_iter) {
+        max_iterations = max_iter;
+    }
+
+    void setThreads(unsigned count) {
+        thread_count = std::max(1u, count);
+    }
+
+    std::vector<int> getBestSolution() const {
+        return best_solution;
+    }
+
+    int getBestCost() const {
+        return best_cost;
+    }
+
+    int getIterations() const {
+        return iterations;
+    }
+
+    // Runs until max_iterations or until no successor beats the best state of the beam
+    bool run() {
+        if (!cost_function) {
+            std::cerr << "Cost function not set!" << std::endl;
+            return false;
+        }
+        size_t n = initial_solution.size();
+        if (n == 0) {
+            std::cerr << "Initial solution not set!" << std::endl;
+            return false;
+        }
+        if (beam_width * 2 * n > 0xFFFFFFFFull) {
+            std::cerr << "Beam too large: successor ids must fit in 32 bits!" << std::endl;
+            return false;
+        }
 
-        while (iteration < max_iterations) {
-            std::vector<int> neighbor = current_solution;
-            // Generate a neighbor by modifying one element deterministically
-            int idx = iteration % neighbor.size();
-            neighbor[idx] = neighbor[idx] - 1;  // decrement element by 1
+        size_t k = beam_width;
+        unsigned threads = static_cast<unsigned>(std::min<size_t>(thread_count, k));
+        for (int buffer = 0; buffer < 2; ++buffer) {
+            states[buffer].assign(k * n, 0);
+            costs[buffer].assign(k, 0);
+            hashes[buffer].assign(k, 0);
+        }
+        successor_costs.assign(k * 2 * n, 0);
+        scratch.assign(threads, std::vector<int>(n));
+        candidates.assign(std::max<size_t>(static_cast<size_t>(threads) * k, k * 2 * n), 0);
+        candidate_counts.assign(threads, 0);
+        selected.assign(k, 0);
+        selected_hashes.assign(k, 0);
+        size_t table_size = 16;
+        while (table_size < 4 * k) {
+            table_size <<= 1;
+        }
+        seen.assign(table_size, 0);
 
-            int neighbor_cost = cost_function(neighbor);
-            if (neighbor_cost < current_cost) {
-                current_solution = neighbor;
-                current_cost = neighbor_cost;
+        std::copy(initial_solution.begin(), initial_solution.end(), states[0].begin());
+        costs[0][0] = cost_function(initial_solution);
+        uint64_t initial_hash = 0;
+        for (size_t i = 0; i < n; ++i) {
+            initial_hash += coordinateHash(i, initial_solution[i]);
+        }
+        hashes[0][0] = initial_hash;
+        best_solution = initial_solution;
+        best_cost = costs[0][0];
+        iterations = 0;
+
+        int current = 0;
+        size_t live = 1;
+        size_t next_live = 0;
+        bool stop = max_iterations <= 0;
+        RoundBarrier barrier(threads);
+
+        // Keeps the best distinct successors among the first count sorted candidates, up to k
+        auto selectSorted = [&](size_t count) {
+            std::fill(seen.begin(), seen.end(), 0);
+            next_live = 0;
+            for (size_t c = 0; c < count && next_live < k; ++c) {
+                uint64_t id = candidates[c] & 0xFFFFFFFFu;
+                size_t parent = static_cast<size_t>(id / (2 * n));
+                size_t i = static_cast<size_t>(id % (2 * n)) / 2;
+                int old_value = states[current][parent * n + i];
+                int new_value = old_value + ((id & 1) ? step_size : -step_size);
+                uint64_t hash = hashes[current][parent] - coordinateHash(i, old_value) + coordinateHash(i, new_value);
+                if (selectDistinct(states[current], candidates[c], hash, next_live)) {
+                    ++next_live;
+                }
+            }
+        };
+
+        // Runs on the last thread to finish expanding: merges the per-thread top k,
+        // keeps the k best distinct successors and decides whether to go on
+        auto select = [&] {
+            size_t total = 0;
+            for (unsigned t = 0; t < threads; ++t) {
+                if (total != t * k) {
+                    std::copy(candidates.begin() + t * k, candidates.begin() + t * k + candidate_counts[t],
+                              candidates.begin() + total);
+                }
+                total += candidate_counts[t];
+            }
+            // Only the global top k are known to be in order, whatever the split across threads
+            size_t kept = std::min(total, k);
+            std::partial_sort(candidates.begin(), candidates.begin() + kept, candidates.begin() + total);
+            selectSorted(kept);
+            size_t successors = live * 2 * n;
+            if (next_live < k && successors > kept) {
+                // Duplicates among them: rank every successor and scan past them
+                for (size_t id = 0; id < successors; ++id) {
+                    candidates[id] = packKey(successor_costs[id], id);
+                }
+                std::sort(candidates.begin(), candidates.begin() + successors);
+                selectSorted(successors);
+            }
+            int beam_best = *std::min_element(costs[current].begin(), costs[current].begin() + live);
+            stop = next_live == 0 || keyCost(selected[0]) >= beam_best;
+        };
+
+        // Runs on the last thread to finish materializing: swaps generations, records the best
+        auto advance = [&] {
+            current ^= 1;
+            live = next_live;
+            ++iterations;
+            if (costs[current][0] < best_cost) {
+                best_cost = costs[current][0];
+                std::copy(states[current].begin(), states[current].begin() + n, best_solution.begin());
             }
-            iteration++;
+            stop = iterations >= max_iterations;
+        };
+
+        auto worker = [&](unsigned thread) {
+            uint64_t* heap = candidates.data() + static_cast<size_t>(thread) * k;
+            while (!stop) {
+                size_t heap_size = 0;
+                for (size_t parent = thread; parent < live; parent += threads) {
+                    expand(parent, states[current], costs[current][parent], scratch[thread], heap, heap_size);
+                }
+                candidate_counts[thread] = heap_size;
+                barrier.arrive(select);
+                if (stop) {
+                    return;
+                }
+
+                int next = current ^ 1;
+                for (size_t slot = thread; slot < next_live; slot += threads) {
+                    uint64_t id = selected[slot] & 0xFFFFFFFFu;
+                    size_t parent = static_cast<size_t>(id / (2 * n));
+                    size_t i = static_cast<size_t>(id % (2 * n)) / 2;
+                    int* target = states[next].data() + slot * n;
+                    std::copy(states[current].begin() + parent * n, states[current].begin() + (parent + 1) * n, target);
+                    target[i] += (id & 1) ? step_size : -step_size;
+                    costs[next][slot] = successor_costs[id];
+                    hashes[next][slot] = selected_hashes[slot];
+                }
+                barrier.arrive(advance);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t) {
+            pool.emplace_back(worker, t);
         }
+        worker(0);
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+        return true;
     }
 };
 
@@ -77,6 +973,22 @@ int main() {
 
     hc.run();
 
+    // Same search with the delta form of the cost: only the changed square is re-evaluated
+    HillClimbing delta_hc;
+    delta_hc.setCostFunction([](const std::vector<int>& solution) {
+        int cost = 0;
+        for (int x : solution) {
+            cost += x * x;
+        }
+        return cost;
+    });
+    delta_hc.setDeltaCostFunction([](const std::vector<int>& solution, size_t index, int new_value) {
+        return new_value * new_value - solution[index] * solution[index];
+    });
+    delta_hc.setInitialSolution(initial_solution);
+    delta_hc.setMaxIterations(10);
+    delta_hc.run();
+
     std::vector<int> best_solution = hc.getCurrentSolution();
     int best_cost = hc.getCurrentCost();
 
@@ -85,6 +997,80 @@ int main() {
         std::cout << x << " ";
     }
     std::cout << "\nCost: " << best_cost << std::endl;
+    std::cout << "Delta evaluation cost: " << delta_hc.getCurrentCost() << std::endl;
+
+    // Steepest ascent on the same example: each iteration takes the best ±1 move
+    HillClimbing steepest;
+    steepest.setSeparableQuadraticCost(std::vector<int>(initial_solution.size(), 1),
+                                       std::vector<int>(initial_solution.size(), 0));
+    steepest.setStrategy(HillClimbing::Strategy::SteepestAscent);
+    steepest.setInitialSolution(initial_solution);
+    steepest.setMaxIterations(10);
+    steepest.run();
+
+    std::cout << "Steepest ascent solution: ";
+    for (int x : steepest.getCurrentSolution()) {
+        std::cout << x << " ";
+    }
+    std::cout << "\nCost: " << steepest.getCurrentCost() << std::endl;
+
+    // Random restarts: 8 climbers from scattered starting points, stopping at the optimum
+    RandomRestartHillClimbing restarts;
+    restarts.setCostFunction([](const std::vector<int>& solution) {
+        int cost = 0;
+        for (int x : solution) {
+            cost += x * x;
+        }
+        return cost;
+    });
+    restarts.setDeltaCostFunction([](const std::vector<int>& solution, size_t index, int new_value) {
+        return new_value * new_value - solution[index] * solution[index];
+    });
+    restarts.setRestartGenerator([](const std::vector<int>& initial, std::mt19937_64& rng) {
+        std::vector<int> start = initial;
+        for (int& x : start) {
+            x += static_cast<int>(rng() % 21) - 10;
+        }
+        return start;
+    });
+    restarts.setInitialSolution(initial_solution);
+    restarts.setClimbers(8);
+    restarts.setThreads(4);
+    restarts.setSeed(42);
+    restarts.setMaxIterations(200);
+    restarts.setRoundSteps(16);
+    restarts.setTargetCost(0);
+    restarts.run();
+
+    std::cout << "Random restart solution: ";
+    for (int x : restarts.getBestSolution()) {
+        std::cout << x << " ";
+    }
+    std::cout << "\nCost: " << restarts.getBestCost() << " (climber " << restarts.getBestClimber() << ")" << std::endl;
+
+    // Local beam search: the 4 best distinct states, expanded together each iteration
+    LocalBeamSearch beam;
+    beam.setCostFunction([](const std::vector<int>& solution) {
+        int cost = 0;
+        for (int x : solution) {
+            cost += x * x;
+        }
+        return cost;
+    });
+    beam.setDeltaCostFunction([](const std::vector<int>& solution, size_t index, int new_value) {
+        return new_value * new_value - solution[index] * solution[index];
+    });
+    beam.setInitialSolution(initial_solution);
+    beam.setBeamWidth(4);
+    beam.setThreads(2);
+    beam.setMaxIterations(10);
+    beam.run();
+
+    std::cout << "Beam search solution: ";
+    for (int x : beam.getBestSolution()) {
+        std::cout << x << " ";
+    }
+    std::cout << "\nCost: " << beam.getBestCost() << " after " << beam.getIterations() << " iterations" << std::endl;
 
     return 0;
 }
@@ -0,0 +1,257 @@
+#pragma once
+
+// Header-only local search core. The state, cost and neighborhood are template parameters,
+// so cost calls inline into the search loop, and the strategy is chosen at compile time.
+//
+// Cost:     cost_type operator()(const State&) const
+//           optional: cost_type delta(const State&, const move_type&) const
+//           Without delta, a move is applied, the full cost recomputed and the move undone.
+// Neighbor: using move_type = ...;
+//           move_type apply(State&, const move_type&) const, returning the move that undoes it
+//           template <typename Rng> move_type propose(const State&, size_t iteration, Rng&)
+//               (first improvement and annealing)
+//           template <typename Visit> void forEach(const State&, Visit&&) const
+//               (steepest; the state may be changed and restored during a visit)
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace local_search {
+
+enum class Strategy {
+    FirstImprovement,  // one proposed neighbor per iteration, taken if it improves
+    Steepest,          // best of the whole neighborhood per iteration, stops at a local optimum
+    Annealing          // proposed neighbor taken with probability exp(-delta / temperature)
+};
+
+// Temperature initial_temperature * alpha^iteration
+struct GeometricCooling {
+    double initial_temperature = 10.0;
+    double alpha = 0.999;
+
+    double start() const {
+        return initial_temperature;
+    }
+
+    double cool(double temperature) const {
+        return temperature * alpha;
+    }
+};
+
+template <typename Cost, typename State, typename Move, typename = void>
+struct HasDelta : std::false_type {};
+
+template <typename Cost, typename State, typename Move>
+struct HasDelta<Cost, State, Move,
+                std::void_t<decltype(std::declval<const Cost&>().delta(std::declval<const State&>(),
+                                                                       std::declval<const Move&>()))>>
+    : std::true_type {};
+
+template <typename State, typename Cost, typename Neighbor, Strategy strategy = Strategy::FirstImprovement,
+          typename Schedule = GeometricCooling, typename Rng = std::mt19937_64>
+class LocalSearch {
+public:
+    using cost_type = decltype(std::declval<const Cost&>()(std::declval<const State&>()));
+    using move_type = typename Neighbor::move_type;
+
+private:
+    State state;
+    cost_type cost;
+    Cost cost_function;
+    Neighbor neighbor;
+    Schedule schedule;
+    Rng rng;
+    size_t max_iterations;
+    size_t iterations;
+
+    // Cost change of move from the current state
+    cost_type evaluate(const move_type& move) {
+        if constexpr (HasDelta<Cost, State, move_type>::value) {
+            return cost_function.delta(state, move);
+        } else {
+            move_type undo = neighbor.apply(state, move);
+            cost_type delta = cost_function(state) - cost;
+            neighbor.apply(state, undo);
+            return delta;
+        }
+    }
+
+    void runFirstImprovement() {
+        for (; iterations < max_iterations; ++iterations) {
+            move_type move = neighbor.propose(state, iterations, rng);
+            cost_type delta = evaluate(move);
+            if (delta < 0) {
+                neighbor.apply(state, move);
+                cost += delta;
+            }
+        }
+    }
+
+    // Ties go to the first neighbor visited
+    void runSteepest() {
+        for (; iterations < max_iterations; ++iterations) {
+            bool improved = false;
+            move_type best_move{};
+            cost_type best_delta{};
+            neighbor.forEach(state, [&](const move_type& move) {
+                cost_type delta = evaluate(move);
+                if (delta < best_delta) {
+                    best_delta = delta;
+                    best_move = move;
+                    improved = true;
+                }
+            });
+            if (!improved) {
+                break;  // local optimum
+            }
+            neighbor.apply(state, best_move);
+            cost += best_delta;
+        }
+    }
+
+    // Ends on the best state seen. That state is copied only when a worsening move leaves it,
+    // not on every improvement.
+    void runAnnealing() {
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        double temperature = schedule.start();
+        State best_state;
+        cost_type best_cost = cost;
+        bool at_best = true;
+        for (; iterations < max_iterations; ++iterations, temperature = schedule.cool(temperature)) {
+            move_type move = neighbor.propose(state, iterations, rng);
+            cost_type delta = evaluate(move);
+            if (delta < 0) {
+                neighbor.apply(state, move);
+                cost += delta;
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    at_best = true;
+                }
+            } else if (temperature > 0 && unit(rng) < std::exp(-static_cast<double>(delta) / temperature)) {
+                if (at_best) {
+                    best_state = state;
+                    at_best = false;
+                }
+                neighbor.apply(state, move);
+                cost += delta;
+            }
+        }
+        if (!at_best) {
+            state = std::move(best_state);
+            cost = best_cost;
+        }
+    }
+
+public:
+    explicit LocalSearch(Cost cost_fn = Cost(), Neighbor neighborhood = Neighbor(), Schedule cooling = Schedule())
+        : state(), cost(std::numeric_limits<cost_type>::max()), cost_function(std::move(cost_fn)),
+          neighbor(std::move(neighborhood)), schedule(std::move(cooling)), rng(), max_iterations(1000),
+          iterations(0) {}
+
+    void setInitialSolution(State solution) {
+        state = std::move(solution);
+        cost = cost_function(state);
+        iterations = 0;
+    }
+
+    // For callers that already know the starting cost
+    void setInitialSolution(State solution, cost_type known_cost) {
+        state = std::move(solution);
+        cost = known_cost;
+        iterations = 0;
+    }
+
+    void setMaxIterations(size_t max_iter) {
+        max_iterations = max_iter;
+    }
+
+    void setSeed(uint64_t seed) {
+        rng.seed(seed);
+    }
+
+    const State& getCurrentSolution() const {
+        return state;
+    }
+
+    // Moves the solution out, leaving the search empty
+    State releaseSolution() {
+        return std::move(state);
+    }
+
+    cost_type getCurrentCost() const {
+        return cost;
+    }
+
+    // Iterations run so far; steepest counts only the moves it took
+    size_t getIterations() const {
+        return iterations;
+    }
+
+    Cost& getCostFunction() {
+        return cost_function;
+    }
+
+    Neighbor& getNeighbor() {
+        return neighbor;
+    }
+
+    void run() {
+        if constexpr (strategy == Strategy::FirstImprovement) {
+            runFirstImprovement();
+        } else if constexpr (strategy == Strategy::Steepest) {
+            runSteepest();
+        } else {
+            runAnnealing();
+        }
+    }
+};
+
+// A proposed change of one coordinate of a std::vector<int>: state[index] becomes new_value
+struct CoordinateMove {
+    size_t index;
+    int new_value;
+};
+
+// Neighbors state[i] ± step. Proposals pick a random coordinate and direction.
+struct CoordinateStep {
+    using move_type = CoordinateMove;
+
+    int step = 1;
+
+    move_type apply(std::vector<int>& state, const move_type& move) const {
+        move_type undo{move.index, state[move.index]};
+        state[move.index] = move.new_value;
+        return undo;
+    }
+
+    template <typename Rng>
+    move_type propose(const std::vector<int>& state, size_t, Rng& rng) const {
+        size_t index = static_cast<size_t>(rng() % state.size());
+        return move_type{index, state[index] + ((rng() & 1) ? step : -step)};
+    }
+
+    template <typename Visit>
+    void forEach(const std::vector<int>& state, Visit&& visit) const {
+        for (size_t i = 0; i < state.size(); ++i) {
+            visit(move_type{i, state[i] - step});
+            visit(move_type{i, state[i] + step});
+        }
+    }
+};
+
+// The original hill climber's single fixed neighbor: iteration i decrements state[i % n] by 1
+struct CyclicDecrement : CoordinateStep {
+    template <typename Rng>
+    move_type propose(const std::vector<int>& state, size_t iteration, Rng&) const {
+        size_t index = iteration % state.size();
+        return move_type{index, state[index] - 1};
+    }
+};
+
+}  // namespace local_search
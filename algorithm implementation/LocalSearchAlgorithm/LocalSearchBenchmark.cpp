@@ -0,0 +1,126 @@
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "LocalSearch.hpp"
+
+// Benchmarks HillClimbing's original std::function + vector copy path against the templated
+// core on the main example (sum of squares, cyclic decrement neighbor) scaled to large n.
+
+namespace {
+
+constexpr size_t kSize = size_t(1) << 20;
+constexpr size_t kFullCostIterations = 200;     // each one is O(n)
+constexpr size_t kDeltaIterations = 50000000;  // each one is O(1)
+
+struct SumOfSquares {
+    int64_t operator()(const std::vector<int>& solution) const {
+        int64_t cost = 0;
+        for (int x : solution) {
+            cost += int64_t(x) * x;
+        }
+        return cost;
+    }
+};
+
+struct SumOfSquaresDelta : SumOfSquares {
+    int64_t delta(const std::vector<int>& solution, const local_search::CoordinateMove& move) const {
+        int64_t old_value = solution[move.index];
+        return int64_t(move.new_value) * move.new_value - old_value * old_value;
+    }
+};
+
+// Original HillClimbing::run: copy the solution, decrement one element, full cost through std::function
+int64_t originalPath(std::vector<int> current_solution, size_t max_iterations,
+                     const std::function<int64_t(const std::vector<int>&)>& cost_function) {
+    int64_t current_cost = cost_function(current_solution);
+    for (size_t iteration = 0; iteration < max_iterations; ++iteration) {
+        std::vector<int> neighbor = current_solution;
+        size_t idx = iteration % neighbor.size();
+        neighbor[idx] = neighbor[idx] - 1;
+        int64_t neighbor_cost = cost_function(neighbor);
+        if (neighbor_cost < current_cost) {
+            current_solution = neighbor;
+            current_cost = neighbor_cost;
+        }
+    }
+    return current_cost;
+}
+
+// In-place moves scored through a std::function delta, as HillClimbing does with setDeltaCostFunction
+int64_t functionDeltaPath(std::vector<int> solution, size_t max_iterations,
+                          const std::function<int64_t(const std::vector<int>&)>& cost_function,
+                          const std::function<int64_t(const std::vector<int>&, size_t, int)>& delta_function) {
+    int64_t cost = cost_function(solution);
+    for (size_t iteration = 0; iteration < max_iterations; ++iteration) {
+        size_t idx = iteration % solution.size();
+        int64_t delta = delta_function(solution, idx, solution[idx] - 1);
+        if (delta < 0) {
+            solution[idx] -= 1;
+            cost += delta;
+        }
+    }
+    return cost;
+}
+
+template <typename Cost, local_search::Strategy strategy = local_search::Strategy::FirstImprovement,
+          typename Neighbor = local_search::CyclicDecrement>
+int64_t corePath(const std::vector<int>& initial, size_t max_iterations, Neighbor neighbor = Neighbor()) {
+    local_search::LocalSearch<std::vector<int>, Cost, Neighbor, strategy> search(Cost(), neighbor);
+    search.setInitialSolution(initial);
+    search.setMaxIterations(max_iterations);
+    search.run();
+    return search.getCurrentCost();
+}
+
+template <typename Run>
+double timeNanosPerIteration(const char* name, size_t iterations, Run&& run) {
+    auto start = std::chrono::steady_clock::now();
+    int64_t cost = run();
+    double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    double per_iteration = nanos / double(iterations);
+    std::cout << name << ": " << per_iteration << " ns/iteration (cost " << cost << ")" << std::endl;
+    return per_iteration;
+}
+
+}  // namespace
+
+int main() {
+    std::mt19937 rng(7);
+    std::vector<int> initial(kSize);
+    for (int& x : initial) {
+        x = static_cast<int>(rng() % 201) - 100;
+    }
+    std::function<int64_t(const std::vector<int>&)> cost_function = SumOfSquares();
+    std::function<int64_t(const std::vector<int>&, size_t, int)> delta_function =
+        [](const std::vector<int>& solution, size_t index, int new_value) {
+            return int64_t(new_value) * new_value - int64_t(solution[index]) * solution[index];
+        };
+
+    std::cout << "n = " << kSize << std::endl;
+    std::cout << "-- full cost, " << kFullCostIterations << " iterations --" << std::endl;
+    double original = timeNanosPerIteration("std::function + copy (original)", kFullCostIterations,
+                                            [&] { return originalPath(initial, kFullCostIterations, cost_function); });
+    double core_full = timeNanosPerIteration("LocalSearch, inline full cost", kFullCostIterations,
+                                             [&] { return corePath<SumOfSquares>(initial, kFullCostIterations); });
+
+    std::cout << "-- delta cost, " << kDeltaIterations << " iterations --" << std::endl;
+    double function_delta = timeNanosPerIteration("std::function delta", kDeltaIterations, [&] {
+        return functionDeltaPath(initial, kDeltaIterations, cost_function, delta_function);
+    });
+    double core_delta = timeNanosPerIteration("LocalSearch, inline delta", kDeltaIterations,
+                                              [&] { return corePath<SumOfSquaresDelta>(initial, kDeltaIterations); });
+
+    std::cout << "-- other strategies, inline delta --" << std::endl;
+    timeNanosPerIteration("LocalSearch annealing", kDeltaIterations, [&] {
+        return corePath<SumOfSquaresDelta, local_search::Strategy::Annealing, local_search::CoordinateStep>(
+            initial, kDeltaIterations);
+    });
+
+    std::cout << "Speedup, full cost: " << original / core_full << "x" << std::endl;
+    std::cout << "Speedup, delta over std::function delta: " << function_delta / core_delta << "x" << std::endl;
+    std::cout << "Speedup, delta over original: " << original / core_delta << "x" << std::endl;
+    return 0;
+}
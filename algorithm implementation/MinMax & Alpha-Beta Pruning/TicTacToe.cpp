@@ -1,15 +1,587 @@
 #include <iostream>
 #include <vector>
 #include <limits>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 using namespace std;
 
+// Largest board the bitboard engine handles, e.g. 15x15 or 16x16
+const int max_cells = 256;
+const int board_words = max_cells / 64;
+const int max_lines = 4 * max_cells;
+
+// Bitboard position on a rows x cols board: bit row * cols + col of cells[side] is set when
+// that side holds the cell. Side 0 is max_player, side 1 is min_player.
+// - hashes[s] is the Zobrist hash of the position seen through symmetry s.
+// - near[c] counts the stones within candidate_radius of cell c, and near_bits marks the
+//   cells where it is non-zero.
+// - line_counts[side][l] counts side's stones on k-cell line l, and line_score is the
+//   default evaluation summed over those lines.
+// make_move / unmake_move keep all of these up to date.
+struct Bitboard {
+    uint64_t cells[2][board_words] = {};
+    uint64_t hashes[8] = {};
+    uint64_t near_bits[board_words] = {};
+    uint16_t near[max_cells] = {};
+    uint8_t line_counts[2][max_lines] = {};
+    long long line_score = 0;
+    int stones = 0;
+};
+
+constexpr uint64_t splitmix64(uint64_t &state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Fixed-size, lock-free transposition table. A slot holds the packed entry and the key XOR
+// the packed entry, so a slot torn by a concurrent writer fails the key check on probe
+// instead of returning mixed data. Every store replaces the slot.
+class TranspositionTable {
+public:
+    enum Bound { EMPTY = 0, EXACT = 1, LOWER = 2, UPPER = 3 };
+
+    struct Entry {
+        int value;
+        Bound bound;
+        int depth; // plies searched below the position, at most 255
+        int move;  // best cell in the canonical frame, -1 if none
+    };
+
+    explicit TranspositionTable(int bits = 18)
+        : mask((size_t(1) << bits) - 1), slots(new Slot[size_t(1) << bits]) {}
+
+    bool probe(uint64_t key, Entry &entry) const {
+        const Slot &slot = slots[key & mask];
+        uint64_t data = slot.data.load(memory_order_relaxed);
+        uint64_t check = slot.check.load(memory_order_relaxed);
+        if ((check ^ data) != key || ((data >> 32) & 3) == EMPTY) return false;
+        entry.value = static_cast<int32_t>(static_cast<uint32_t>(data));
+        entry.bound = static_cast<Bound>((data >> 32) & 3);
+        entry.depth = static_cast<int>((data >> 34) & 0xFF);
+        entry.move = static_cast<int>((data >> 42) & 0xFFFF) - 1;
+        return true;
+    }
+
+    void store(uint64_t key, const Entry &entry) {
+        uint64_t depth = static_cast<uint64_t>(entry.depth < 255 ? entry.depth : 255);
+        uint64_t data = static_cast<uint32_t>(entry.value) | static_cast<uint64_t>(entry.bound) << 32 |
+                        depth << 34 | static_cast<uint64_t>((entry.move + 1) & 0xFFFF) << 42;
+        Slot &slot = slots[key & mask];
+        slot.data.store(data, memory_order_relaxed);
+        slot.check.store(key ^ data, memory_order_relaxed);
+    }
+
+    void clear() {
+        for (size_t i = 0; i <= mask; ++i) {
+            slots[i].data.store(0, memory_order_relaxed);
+            slots[i].check.store(0, memory_order_relaxed);
+        }
+    }
+
+private:
+    struct Slot {
+        atomic<uint64_t> check{0};
+        atomic<uint64_t> data{0};
+    };
+
+    size_t mask;
+    unique_ptr<Slot[]> slots;
+};
+
+inline int lowest_bit(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
 class MinMaxAlphaBeta {
 public:
     char max_player = 'X'; // AI
     char min_player = 'O'; // Human
 
+    // Board shape: rows x cols, k in a row wins. Change through configure().
+    int rows = 3;
+    int cols = 3;
+    int k = 3;
+    // Only empty cells within this distance of a stone are searched. A radius of at least
+    // max(rows, cols) - 1 makes the search exhaustive, as it is on the default 3x3 board.
+    int candidate_radius = 2;
+
+    // Iterative deepening in get_best_move stops at this budget (zero for none) or at
+    // max_depth plies (zero for none), whichever comes first
+    chrono::milliseconds time_budget{1000};
+    int max_depth = 0;
+    int aspiration_window = 50;
+
+    long long nodes_searched = 0; // positions visited by the bitboard searches
+    int completed_depth = 0;      // depth of the last iteration get_best_move finished
+
+    // Shared by min_max and alpha_beta and kept across calls; positions are stored once per
+    // symmetry class, under the smallest of their hashes
+    TranspositionTable table;
+    bool use_transposition_table = true;
+
+    // Static evaluation of an undecided position, positive when it favours max_player. It is
+    // clamped to well below the win scores, and must give symmetric positions equal values
+    // while the table is in use. Unset, default_evaluation is used.
+    function<int(const MinMaxAlphaBeta &, const Bitboard &)> evaluation;
+
+    static const int win_score = 1 << 24;                   // a win at ply p scores win_score - p
+    static const int win_threshold = win_score - max_cells; // every win scores at least this much
+    static const int infinity = 1 << 30;
+
+    MinMaxAlphaBeta() {
+        configure(3, 3, 3);
+    }
+
+    // Sets up an m,n,k board and rebuilds every table derived from it
+    bool configure(int board_rows, int board_cols, int in_a_row, int radius = 2) {
+        if (board_rows < 1 || board_cols < 1 || board_rows * board_cols > max_cells || in_a_row < 1 ||
+            in_a_row > max(board_rows, board_cols) || in_a_row > 255 || radius < 1) {
+            cerr << "Unsupported board: " << board_rows << "x" << board_cols << ", k = " << in_a_row << endl;
+            return false;
+        }
+        rows = board_rows;
+        cols = board_cols;
+        k = in_a_row;
+        candidate_radius = radius;
+        cells = rows * cols;
+        words = (cells + 63) / 64;
+        for (int w = 0; w < board_words; ++w) {
+            int low = w * 64;
+            valid_bits[w] = cells >= low + 64 ? ~0ull : cells > low ? (1ull << (cells - low)) - 1 : 0;
+        }
+
+        // Rotations and reflections that map the board onto itself: all 8 on a square board,
+        // the 4 that keep rows and columns apart otherwise
+        symmetry_count = rows == cols ? 8 : 4;
+        symmetry_forward.assign(8 * cells, 0);
+        symmetry_inverse.assign(8 * cells, 0);
+        for (int cell = 0; cell < cells; ++cell) {
+            int row = cell / cols, col = cell % cols, last_row = rows - 1, last_col = cols - 1;
+            int images[8][2] = {{row, col}, {last_row - row, last_col - col}, {row, last_col - col},
+                                {last_row - row, col}, {col, last_row - row}, {last_col - col, row},
+                                {col, row}, {last_col - col, last_row - row}};
+            for (int symmetry = 0; symmetry < symmetry_count; ++symmetry) {
+                int image = images[symmetry][0] * cols + images[symmetry][1];
+                symmetry_forward[symmetry * cells + cell] = image;
+                symmetry_inverse[symmetry * cells + image] = cell;
+            }
+        }
+
+        // Zobrist keys per (side, cell), and the key each pair contributes through each symmetry
+        uint64_t state = 0x5EED;
+        vector<uint64_t> keys(2 * cells);
+        for (uint64_t &key : keys) key = splitmix64(state);
+        max_to_move_key = splitmix64(state);
+        symmetric_keys.assign(2 * cells * 8, 0);
+        for (int side = 0; side < 2; ++side) {
+            for (int cell = 0; cell < cells; ++cell) {
+                for (int symmetry = 0; symmetry < symmetry_count; ++symmetry) {
+                    symmetric_keys[(side * cells + cell) * 8 + symmetry] =
+                        keys[side * cells + symmetry_forward[symmetry * cells + cell]];
+                }
+            }
+        }
+
+        // Every k-cell line, and for each cell the lines through it, so a move only updates
+        // and tests its own lines
+        line_count = 0;
+        vector<vector<int>> lines_through(cells);
+        int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+        for (int cell = 0; cell < cells; ++cell) {
+            for (int d = 0; d < (k == 1 ? 1 : 4); ++d) {
+                int *direction = directions[d];
+                int end_row = cell / cols + direction[0] * (k - 1), end_col = cell % cols + direction[1] * (k - 1);
+                if (end_row < 0 || end_row >= rows || end_col < 0 || end_col >= cols) continue;
+                for (int step = 0; step < k; ++step) {
+                    int on_line = (cell / cols + direction[0] * step) * cols + cell % cols + direction[1] * step;
+                    lines_through[on_line].push_back(line_count);
+                }
+                ++line_count;
+            }
+        }
+        lines_start.assign(cells + 1, 0);
+        lines_index.clear();
+        for (int cell = 0; cell < cells; ++cell) {
+            lines_start[cell] = static_cast<int>(lines_index.size());
+            lines_index.insert(lines_index.end(), lines_through[cell].begin(), lines_through[cell].end());
+        }
+        lines_start[cells] = static_cast<int>(lines_index.size());
+
+        // Cells within candidate_radius of each cell, itself included
+        neighbors_start.assign(cells + 1, 0);
+        neighbors.clear();
+        for (int cell = 0; cell < cells; ++cell) {
+            neighbors_start[cell] = static_cast<int>(neighbors.size());
+            for (int row = max(0, cell / cols - radius); row <= min(rows - 1, cell / cols + radius); ++row) {
+                for (int col = max(0, cell % cols - radius); col <= min(cols - 1, cell % cols + radius); ++col) {
+                    neighbors.push_back(row * cols + col);
+                }
+            }
+        }
+        neighbors_start[cells] = static_cast<int>(neighbors.size());
+
+        window_weights.assign(k + 1, 0);
+        for (int count = 1, weight = 1; count <= k; ++count, weight = min(weight * 10, 1000000)) {
+            window_weights[count] = weight;
+        }
+
+        // Per-ply move lists and ordering state, sized once so a search node does not allocate
+        move_buffer.assign((cells + 1) * cells, 0);
+        move_scores.assign((cells + 1) * cells, 0);
+        killers.assign(2 * (cells + 1), -1);
+        history.assign(2 * cells, 0);
+        table.clear();
+        return true;
+    }
+
+    // Bitboard engine: moves are made and unmade in place, generated by iterating the empty
+    // candidate bits, and wins are tested only against the precomputed lines through the last
+    // move, so a search node does no heap allocation
+    Bitboard to_bitboard(vector<vector<char>> &board) {
+        Bitboard bits;
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < cols; ++col) {
+                if (board[row][col] == max_player) make_move(bits, row * cols + col, 0);
+                else if (board[row][col] == min_player) make_move(bits, row * cols + col, 1);
+            }
+        }
+        return bits;
+    }
+
+    void make_move(Bitboard &board, int cell, int side) {
+        board.cells[side][cell >> 6] |= 1ull << (cell & 63);
+        ++board.stones;
+        const uint64_t *keys = &symmetric_keys[(side * cells + cell) * 8];
+        for (int symmetry = 0; symmetry < symmetry_count; ++symmetry) board.hashes[symmetry] ^= keys[symmetry];
+        for (int i = neighbors_start[cell]; i < neighbors_start[cell + 1]; ++i) {
+            int near = neighbors[i];
+            if (board.near[near]++ == 0) board.near_bits[near >> 6] |= 1ull << (near & 63);
+        }
+        for (int i = lines_start[cell]; i < lines_start[cell + 1]; ++i) {
+            int line = lines_index[i];
+            board.line_score -= line_value(board, line);
+            ++board.line_counts[side][line];
+            board.line_score += line_value(board, line);
+        }
+    }
+
+    void unmake_move(Bitboard &board, int cell, int side) {
+        board.cells[side][cell >> 6] &= ~(1ull << (cell & 63));
+        --board.stones;
+        const uint64_t *keys = &symmetric_keys[(side * cells + cell) * 8];
+        for (int symmetry = 0; symmetry < symmetry_count; ++symmetry) board.hashes[symmetry] ^= keys[symmetry];
+        for (int i = neighbors_start[cell]; i < neighbors_start[cell + 1]; ++i) {
+            int near = neighbors[i];
+            if (--board.near[near] == 0) board.near_bits[near >> 6] &= ~(1ull << (near & 63));
+        }
+        for (int i = lines_start[cell]; i < lines_start[cell + 1]; ++i) {
+            int line = lines_index[i];
+            board.line_score -= line_value(board, line);
+            --board.line_counts[side][line];
+            board.line_score += line_value(board, line);
+        }
+    }
+
+    uint64_t empty_cells(const Bitboard &board, int word) const {
+        return valid_bits[word] & ~(board.cells[0][word] | board.cells[1][word]);
+    }
+
+    bool is_full(const Bitboard &board) const {
+        return board.stones == cells;
+    }
+
+    // Whether the move just played at cell completed a line for its side
+    bool is_win(const Bitboard &board, int cell, int side) const {
+        for (int i = lines_start[cell]; i < lines_start[cell + 1]; ++i) {
+            if (board.line_counts[side][lines_index[i]] == k) return true;
+        }
+        return false;
+    }
+
+    // +1 / -1 for a side that already holds a line, 0 otherwise
+    int terminal_score(const Bitboard &board) const {
+        for (int line = 0; line < line_count; ++line) {
+            if (board.line_counts[0][line] == k) return 1;
+            if (board.line_counts[1][line] == k) return -1;
+        }
+        return 0;
+    }
+
+    // What a k-cell line adds to the default evaluation: 10^(stones - 1) for the side holding
+    // all of its stones, nothing when both sides have stones on it
+    long long line_value(const Bitboard &board, int line) const {
+        int mine = board.line_counts[0][line], theirs = board.line_counts[1][line];
+        if (theirs == 0) return window_weights[mine];
+        if (mine == 0) return -window_weights[theirs];
+        return 0;
+    }
+
+    // Sum of line_value over all lines, kept incrementally by make_move / unmake_move
+    int default_evaluation(const Bitboard &board) const {
+        return static_cast<int>(max<long long>(-win_threshold / 2, min<long long>(win_threshold / 2, board.line_score)));
+    }
+
+    int evaluate(const Bitboard &board) const {
+        if (!evaluation) return default_evaluation(board);
+        return max(-win_threshold / 2, min(win_threshold / 2, evaluation(*this, board)));
+    }
+
+    // Table key of the position's symmetry class; symmetry maps this board onto the canonical one
+    uint64_t position_key(const Bitboard &board, bool is_maximizing, int &symmetry) const {
+        symmetry = 0;
+        for (int s = 1; s < symmetry_count; ++s) {
+            if (board.hashes[s] < board.hashes[symmetry]) symmetry = s;
+        }
+        return board.hashes[symmetry] ^ (is_maximizing ? max_to_move_key : 0);
+    }
+
+    // Candidate moves into moves: empty cells near a stone, or on an empty board the centre
+    // (every cell when the search is exhaustive)
+    int generate_moves(const Bitboard &board, int *moves) const {
+        int count = 0;
+        if (board.stones == 0 && candidate_radius < max(rows, cols) - 1) {
+            moves[count++] = (rows / 2) * cols + cols / 2;
+            return count;
+        }
+        for (int w = 0; w < words; ++w) {
+            uint64_t bits = empty_cells(board, w) & (board.stones ? board.near_bits[w] : ~0ull);
+            for (; bits; bits &= bits - 1) moves[count++] = w * 64 + lowest_bit(bits);
+        }
+        return count;
+    }
+
+    // Exact value of an undecided position with the given side to move
+    int min_max(Bitboard &board, bool is_maximizing, int ply = 0) {
+        ++nodes_searched;
+        int side = is_maximizing ? 0 : 1;
+        int depth = cells - board.stones;
+        int symmetry = 0;
+        uint64_t key = 0;
+        if (use_transposition_table) {
+            key = position_key(board, is_maximizing, symmetry);
+            TranspositionTable::Entry entry;
+            if (table.probe(key, entry) && entry.bound == TranspositionTable::EXACT && entry.depth >= min(depth, 255)) {
+                return score_from_table(entry.value, ply);
+            }
+        }
+
+        int *moves = &move_buffer[ply * cells];
+        int count = generate_moves(board, moves);
+        int best = is_maximizing ? -infinity : infinity;
+        int best_cell = -1;
+        for (int i = 0; i < count; ++i) {
+            int cell = moves[i];
+            make_move(board, cell, side);
+            int value;
+            if (is_win(board, cell, side)) value = is_maximizing ? win_score - (ply + 1) : -(win_score - (ply + 1));
+            else if (is_full(board)) value = 0;
+            else value = min_max(board, !is_maximizing, ply + 1);
+            unmake_move(board, cell, side);
+            if (is_maximizing ? value > best : value < best) {
+                best = value;
+                best_cell = cell;
+            }
+        }
+        if (use_transposition_table) {
+            table.store(key, {score_to_table(best, ply), TranspositionTable::EXACT, depth,
+                              symmetry_forward[symmetry * cells + best_cell]});
+        }
+        return best;
+    }
+
+    // Depth-limited principal variation search, fail-soft: a result <= alpha is an upper bound
+    // and one >= beta a lower bound, which is how it is stored. Undecided positions at depth 0
+    // are scored by evaluate(). Moves are tried in order: table move, the ply's two killers,
+    // then by history score. Every move after the first is searched with a null window and
+    // searched again with the full window only if it lands inside it.
+    int alpha_beta(Bitboard &board, int depth, int ply, bool is_maximizing, int alpha, int beta) {
+        ++nodes_searched;
+        if (time_up()) return 0;
+        int side = is_maximizing ? 0 : 1;
+        depth = min(depth, cells - board.stones);
+        if (depth <= 0) return evaluate(board);
+
+        int alpha_start = alpha, beta_start = beta;
+        int symmetry = 0;
+        uint64_t key = 0;
+        int hash_move = -1;
+        if (use_transposition_table) {
+            key = position_key(board, is_maximizing, symmetry);
+            TranspositionTable::Entry entry;
+            if (table.probe(key, entry)) {
+                int value = score_from_table(entry.value, ply);
+                // The root always searches, so it can report its best move
+                if (ply > 0 && entry.depth >= min(depth, 255)) {
+                    if (entry.bound == TranspositionTable::EXACT) return value;
+                    if (entry.bound == TranspositionTable::LOWER && value >= beta) return value;
+                    if (entry.bound == TranspositionTable::UPPER && value <= alpha) return value;
+                }
+                if (entry.move >= 0) hash_move = symmetry_inverse[symmetry * cells + entry.move];
+            }
+        }
+
+        int *moves = &move_buffer[ply * cells];
+        int *scores = &move_scores[ply * cells];
+        int count = generate_moves(board, moves);
+        int *ply_killers = &killers[ply * 2];
+        for (int i = 0; i < count; ++i) {
+            int cell = moves[i];
+            scores[i] = cell == hash_move        ? infinity
+                      : cell == ply_killers[0] ? infinity - 1
+                      : cell == ply_killers[1] ? infinity - 2
+                                               : history[side * cells + cell];
+        }
+
+        int best = is_maximizing ? -infinity : infinity;
+        int best_cell = -1;
+        for (int i = 0; i < count; ++i) {
+            // Selection sort step: bring the best remaining move to position i
+            int pick = i;
+            for (int j = i + 1; j < count; ++j) {
+                if (scores[j] > scores[pick]) pick = j;
+            }
+            swap(moves[i], moves[pick]);
+            swap(scores[i], scores[pick]);
+            int cell = moves[i];
+
+            make_move(board, cell, side);
+            int value;
+            if (is_win(board, cell, side)) {
+                value = is_maximizing ? win_score - (ply + 1) : -(win_score - (ply + 1));
+            } else if (is_full(board)) {
+                value = 0;
+            } else if (i == 0) {
+                value = alpha_beta(board, depth - 1, ply + 1, !is_maximizing, alpha, beta);
+            } else if (is_maximizing) {
+                value = alpha_beta(board, depth - 1, ply + 1, false, alpha, alpha + 1);
+                if (value > alpha && value < beta) value = alpha_beta(board, depth - 1, ply + 1, false, alpha, beta);
+            } else {
+                value = alpha_beta(board, depth - 1, ply + 1, true, beta - 1, beta);
+                if (value < beta && value > alpha) value = alpha_beta(board, depth - 1, ply + 1, true, alpha, beta);
+            }
+            unmake_move(board, cell, side);
+            if (out_of_time) return 0;
+
+            if (is_maximizing ? value > best : value < best) {
+                best = value;
+                best_cell = cell;
+                if (ply == 0) root_best_cell = cell;
+            }
+            if (is_maximizing) alpha = max(alpha, best);
+            else beta = min(beta, best);
+            if (beta <= alpha) {
+                if (cell != ply_killers[0]) {
+                    ply_killers[1] = ply_killers[0];
+                    ply_killers[0] = cell;
+                }
+                history[side * cells + cell] += depth * depth;
+                break;
+            }
+        }
+        if (use_transposition_table) {
+            TranspositionTable::Bound bound = best <= alpha_start ? TranspositionTable::UPPER
+                                            : best >= beta_start  ? TranspositionTable::LOWER
+                                                                  : TranspositionTable::EXACT;
+            table.store(key, {score_to_table(best, ply), bound, depth, symmetry_forward[symmetry * cells + best_cell]});
+        }
+        return best;
+    }
+
+    // Cell of the best move for the side to move, or -1 if the game is over. Iterative
+    // deepening, each iteration searched inside an aspiration window around the previous
+    // score and widened on failure, until time_budget or max_depth runs out, a forced result
+    // is found, or the search reaches the end of the game. The move of the deepest finished
+    // iteration is returned; if none finished, the first candidate.
+    int get_best_cell(Bitboard &board, bool is_maximizing) {
+        if (terminal_score(board) != 0 || is_full(board)) return -1;
+        deadline = chrono::steady_clock::now() + time_budget;
+        deadline_active = time_budget.count() > 0;
+        out_of_time = false;
+        completed_depth = 0;
+        fill(killers.begin(), killers.end(), -1);
+        for (int &score : history) score /= 2;
+
+        int best_cell = -1;
+        generate_moves(board, &move_buffer[0]);
+        best_cell = move_buffer[0];
+        int remaining = cells - board.stones;
+        int limit = max_depth > 0 ? min(max_depth, remaining) : remaining;
+        int previous = 0;
+        for (int depth = 1; depth <= limit; ++depth) {
+            int alpha = -infinity, beta = infinity;
+            if (depth > 1 && abs(previous) < win_threshold) {
+                alpha = previous - aspiration_window;
+                beta = previous + aspiration_window;
+            }
+            int value;
+            for (;;) {
+                root_best_cell = -1;
+                value = alpha_beta(board, depth, 0, is_maximizing, alpha, beta);
+                if (out_of_time) break;
+                if (value <= alpha && alpha > -infinity) alpha = -infinity;
+                else if (value >= beta && beta < infinity) beta = infinity;
+                else break;
+            }
+            if (out_of_time) break;
+            best_cell = root_best_cell;
+            previous = value;
+            completed_depth = depth;
+            if (abs(value) >= win_threshold) break; // forced win or loss
+        }
+        deadline_active = false;
+        return best_cell;
+    }
+
+    // The board-based entry points below search on the bitboard engine. They solve the position
+    // exactly and return +1 / 0 / -1. depth is the number of plies already played, kept for
+    // compatibility; the window bounds are on the same +1 / 0 / -1 scale.
     int min_max(vector<vector<char>> &board, int depth, bool is_maximizing) {
+        (void)depth;
+        Bitboard bits = to_bitboard(board);
+        int score = terminal_score(bits);
+        if (score != 0) return score;
+        if (is_full(bits)) return 0;
+        return sign(min_max(bits, is_maximizing));
+    }
+
+    int alpha_beta(vector<vector<char>> &board, int depth, bool is_maximizing, int alpha, int beta) {
+        (void)depth;
+        Bitboard bits = to_bitboard(board);
+        int score = terminal_score(bits);
+        if (score != 0) return score;
+        if (is_full(bits)) return 0;
+        auto to_internal = [](int bound) {
+            return bound <= -2 ? -infinity : bound >= 2 ? infinity : bound * win_threshold;
+        };
+        return sign(alpha_beta(bits, cells - bits.stones, 0, is_maximizing, to_internal(alpha), to_internal(beta)));
+    }
+
+    pair<int, int> get_best_move(vector<vector<char>> &board, bool is_maximizing) {
+        Bitboard bits = to_bitboard(board);
+        int cell = get_best_cell(bits, is_maximizing);
+        if (cell < 0) return {-1, -1};
+        return {cell / cols, cell % cols};
+    }
+
+    // Reference implementations on the vector board, kept for comparison with the bitboard engine
+    int min_max_reference(vector<vector<char>> &board, int depth, bool is_maximizing) {
         char winner = check_winner(board);
         if (winner == max_player) return 1;
         else if (winner == min_player) return -1;
@@ -19,20 +591,20 @@ public:
             int best = numeric_limits<int>::min();
             for (auto &move : get_possible_moves(board)) {
                 auto new_board = make_move(board, move, max_player);
-                best = max(best, min_max(new_board, depth + 1, false));
+                best = max(best, min_max_reference(new_board, depth + 1, false));
             }
             return best;
         } else {
             int best = numeric_limits<int>::max();
             for (auto &move : get_possible_moves(board)) {
                 auto new_board = make_move(board, move, min_player);
-                best = min(best, min_max(new_board, depth + 1, true));
+                best = min(best, min_max_reference(new_board, depth + 1, true));
             }
             return best;
         }
     }
 
-    int alpha_beta(vector<vector<char>> &board, int depth, bool is_maximizing, int alpha, int beta) {
+    int alpha_beta_reference(vector<vector<char>> &board, int depth, bool is_maximizing, int alpha, int beta) {
         char winner = check_winner(board);
         if (winner == max_player) return 1;
         else if (winner == min_player) return -1;
@@ -42,7 +614,7 @@ public:
             int best = numeric_limits<int>::min();
             for (auto &move : get_possible_moves(board)) {
                 auto new_board = make_move(board, move, max_player);
-                best = max(best, alpha_beta(new_board, depth + 1, false, alpha, beta));
+                best = max(best, alpha_beta_reference(new_board, depth + 1, false, alpha, beta));
                 alpha = max(alpha, best);
                 if (beta <= alpha) break;
             }
@@ -51,7 +623,7 @@ public:
             int best = numeric_limits<int>::max();
             for (auto &move : get_possible_moves(board)) {
                 auto new_board = make_move(board, move, min_player);
-                best = min(best, alpha_beta(new_board, depth + 1, true, alpha, beta));
+                best = min(best, alpha_beta_reference(new_board, depth + 1, true, alpha, beta));
                 beta = min(beta, best);
                 if (beta <= alpha) break;
             }
@@ -59,13 +631,13 @@ public:
         }
     }
 
-    pair<int, int> get_best_move(vector<vector<char>> &board, bool is_maximizing) {
+    pair<int, int> get_best_move_reference(vector<vector<char>> &board, bool is_maximizing) {
         pair<int, int> best_move = {-1, -1};
         int best_value = is_maximizing ? numeric_limits<int>::min() : numeric_limits<int>::max();
 
         for (auto &move : get_possible_moves(board)) {
             auto new_board = make_move(board, move, is_maximizing ? max_player : min_player);
-            int board_value = alpha_beta(new_board, 0, !is_maximizing, numeric_limits<int>::min(), numeric_limits<int>::max());
+            int board_value = alpha_beta_reference(new_board, 0, !is_maximizing, numeric_limits<int>::min(), numeric_limits<int>::max());
             if ((is_maximizing && board_value > best_value) || (!is_maximizing && board_value < best_value)) {
                 best_value = board_value;
                 best_move = move;
@@ -76,8 +648,8 @@ public:
 
     vector<pair<int, int>> get_possible_moves(vector<vector<char>> &board) {
         vector<pair<int, int>> moves;
-        for (int row = 0; row < 3; ++row) {
-            for (int col = 0; col < 3; ++col) {
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < cols; ++col) {
                 if (board[row][col] == ' ') {
                     moves.push_back({row, col});
                 }
@@ -92,24 +664,34 @@ public:
         return new_board;
     }
 
+    // The player with k in a row in any direction, or ' '
     char check_winner(vector<vector<char>> &board) {
-        for (int i = 0; i < 3; ++i) {
-            if (board[i][0] == board[i][1] && board[i][1] == board[i][2] && board[i][0] != ' ') return board[i][0];
-            if (board[0][i] == board[1][i] && board[1][i] == board[2][i] && board[0][i] != ' ') return board[0][i];
+        int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < cols; ++col) {
+                char player = board[row][col];
+                if (player == ' ') continue;
+                for (auto &direction : directions) {
+                    int step = 1;
+                    for (; step < k; ++step) {
+                        int r = row + direction[0] * step, c = col + direction[1] * step;
+                        if (r < 0 || r >= rows || c < 0 || c >= cols || board[r][c] != player) break;
+                    }
+                    if (step == k) return player;
+                }
+            }
         }
-        if (board[0][0] == board[1][1] && board[1][1] == board[2][2] && board[0][0] != ' ') return board[0][0];
-        if (board[0][2] == board[1][1] && board[1][1] == board[2][0] && board[0][2] != ' ') return board[0][2];
         return ' ';
     }
 
     void print_board(vector<vector<char>> &board) {
-        for (int row = 0; row < 3; ++row) {
-            for (int col = 0; col < 3; ++col) {
+        for (int row = 0; row < rows; ++row) {
+            for (int col = 0; col < cols; ++col) {
                 cout << board[row][col];
-                if (col < 2) cout << " | ";
+                if (col < cols - 1) cout << " | ";
             }
             cout << endl;
-            if (row < 2) cout << "---------" << endl;
+            if (row < rows - 1) cout << string(4 * cols - 3, '-') << endl;
         }
     }
 
@@ -122,11 +704,63 @@ public:
         }
         return true;
     }
+
+private:
+    int cells = 9;
+    int words = 1;
+    uint64_t valid_bits[board_words] = {};
+    int symmetry_count = 8;
+    vector<int> symmetry_forward;   // [symmetry * cells + cell] -> image of cell
+    vector<int> symmetry_inverse;
+    vector<uint64_t> symmetric_keys; // [(side * cells + cell) * 8 + symmetry]
+    uint64_t max_to_move_key = 0;
+    int line_count = 0;
+    vector<int> lines_start;         // lines through cell c: lines_index[lines_start[c] .. lines_start[c + 1])
+    vector<int> lines_index;
+    vector<int> neighbors_start;     // cells within candidate_radius, same layout
+    vector<int> neighbors;
+    vector<int> window_weights;
+    vector<int> move_buffer;         // [ply * cells + i]
+    vector<int> move_scores;
+    vector<int> killers;             // [ply * 2 + slot]
+    vector<int> history;             // [side * cells + cell]
+    int root_best_cell = -1;
+    chrono::steady_clock::time_point deadline;
+    bool deadline_active = false;
+    bool out_of_time = false;
+
+    static int sign(int value) {
+        return (value > 0) - (value < 0);
+    }
+
+    // Wins are stored relative to the position, so they stay correct when reached at another ply
+    static int score_to_table(int score, int ply) {
+        if (score >= win_threshold) return score + ply;
+        if (score <= -win_threshold) return score - ply;
+        return score;
+    }
+
+    static int score_from_table(int score, int ply) {
+        if (score >= win_threshold) return score - ply;
+        if (score <= -win_threshold) return score + ply;
+        return score;
+    }
+
+    // Checks the clock every 1024 nodes
+    bool time_up() {
+        if (!out_of_time && deadline_active && (nodes_searched & 1023) == 0 && chrono::steady_clock::now() >= deadline) {
+            out_of_time = true;
+        }
+        return out_of_time;
+    }
 };
 
-int main() {
+// Usage: TicTacToe [rows cols k [milliseconds per AI move]], 3 3 3 by default
+int main(int argc, char *argv[]) {
     MinMaxAlphaBeta game;
-    vector<vector<char>> board(3, vector<char>(3, ' '));
+    if (argc >= 4 && !game.configure(atoi(argv[1]), atoi(argv[2]), atoi(argv[3]))) return 1;
+    if (argc >= 5) game.time_budget = chrono::milliseconds(atoi(argv[4]));
+    vector<vector<char>> board(game.rows, vector<char>(game.cols, ' '));
 
     while (true) {
         game.print_board(board);
@@ -141,21 +775,23 @@ int main() {
 
         // Human player's move (O)
         int row, col;
-        cout << "Enter your move row (0-2): ";
+        cout << "Enter your move row (0-" << game.rows - 1 << "): ";
         if (!(cin >> row)) {
+            if (cin.eof()) break;
             cout << "Invalid input. Try again." << endl;
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
             continue;
         }
-        cout << "Enter your move col (0-2): ";
+        cout << "Enter your move col (0-" << game.cols - 1 << "): ";
         if (!(cin >> col)) {
+            if (cin.eof()) break;
             cout << "Invalid input. Try again." << endl;
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
             continue;
         }
-        if (row < 0 || row >= 3 || col < 0 || col >= 3 || board[row][col] != ' ') {
+        if (row < 0 || row >= game.rows || col < 0 || col >= game.cols || board[row][col] != ' ') {
             cout << "Invalid move. Try again." << endl;
             continue;
         }
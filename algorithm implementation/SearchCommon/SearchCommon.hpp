@@ -0,0 +1,775 @@
+#pragma once
+
+// Support code shared by the graph search programs (InformedSearch, UninformedSearch). Both
+// include it as "../SearchCommon/SearchCommon.hpp", so no extra include path is needed.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <intrin.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace search_common {
+
+// ------------------------ Search Instrumentation ------------------------
+// Per-query counters and process-wide latency histograms, compiled in with -DSEARCH_STATS.
+// Without it the hooks expand to nothing and a SearchStats handed to a query stays zeroed.
+struct SearchStats {
+    uint64_t expanded = 0;      // nodes taken off the frontier and expanded
+    uint64_t generated = 0;     // successors examined
+    uint64_t pushes = 0;        // frontier inserts: heap inserts and decrease-keys, queue and stack pushes
+    uint64_t pops = 0;
+    size_t peak_frontier = 0;
+    size_t peak_memory = 0;     // bytes held by the query's search structures
+    uint64_t wall_ns = 0;
+};
+
+// Log2 latency buckets: bucket i counts queries that took less than 2^i ns (and at least 2^(i-1))
+class LatencyHistogram {
+public:
+    static constexpr int kBuckets = 48;
+
+    explicit LatencyHistogram(std::string name) : name(std::move(name)) {}
+
+    void record(uint64_t ns) {
+        int bucket = 0;
+        while (bucket < kBuckets - 1 && (ns >> bucket) != 0) ++bucket;
+        buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        total_ns.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t seen = max_ns.load(std::memory_order_relaxed);
+        while (ns > seen && !max_ns.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Histogram for one search kind, created on first use and alive for the whole process
+    static LatencyHistogram& named(const std::string& name) {
+        std::lock_guard<std::mutex> guard(registryLock());
+        for (auto& histogram : registry()) {
+            if (histogram->name == name) return *histogram;
+        }
+        registry().push_back(std::make_unique<LatencyHistogram>(name));
+        return *registry().back();
+    }
+
+    // {"a_star": {"count": n, "total_ns": t, "max_ns": m, "buckets": [{"lt_ns": 1024, "count": c}, ...]}, ...}
+    static void dumpJson(std::ostream& out) {
+        std::lock_guard<std::mutex> guard(registryLock());
+        out << "{";
+        for (size_t h = 0; h < registry().size(); ++h) {
+            const LatencyHistogram& histogram = *registry()[h];
+            out << (h ? ", " : "") << "\"" << histogram.name << "\": {\"count\": " << histogram.count.load()
+                << ", \"total_ns\": " << histogram.total_ns.load() << ", \"max_ns\": " << histogram.max_ns.load()
+                << ", \"buckets\": [";
+            bool first = true;
+            for (int i = 0; i < kBuckets; ++i) {
+                uint64_t n = histogram.buckets[i].load();
+                if (n == 0) continue;
+                out << (first ? "" : ", ") << "{\"lt_ns\": " << (uint64_t(1) << i) << ", \"count\": " << n << "}";
+                first = false;
+            }
+            out << "]}";
+        }
+        out << "}" << std::endl;
+    }
+
+private:
+    std::string name;
+    std::atomic<uint64_t> buckets[kBuckets] = {};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+
+    static std::vector<std::unique_ptr<LatencyHistogram>>& registry() {
+        static std::vector<std::unique_ptr<LatencyHistogram>> histograms;
+        return histograms;
+    }
+
+    static std::mutex& registryLock() {
+        static std::mutex lock;
+        return lock;
+    }
+};
+
+template <class T>
+size_t capacityBytes(const std::vector<T>& values) {
+    return values.capacity() * sizeof(T);
+}
+
+// Times a query into its histogram and, when given, into stats->wall_ns
+class SearchTimer {
+public:
+    SearchTimer(SearchStats* stats, LatencyHistogram& histogram)
+        : stats(stats), histogram(histogram), start(std::chrono::steady_clock::now()) {}
+
+    ~SearchTimer() {
+        uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        histogram.record(ns);
+        if (stats) stats->wall_ns = ns;
+    }
+
+private:
+    SearchStats* stats;
+    LatencyHistogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Persistent thread pool for data-parallel loops. Each worker owns a range of indices and
+// takes small chunks from its front; an idle worker steals the back half of a busy one's range.
+// A body may also take the id of the worker running it, for per-worker buffers. The pool runs
+// one job at a time: calls from different threads wait for their turn, and a call made from
+// inside a body of the same pool runs inline on the calling worker.
+class WorkStealingPool {
+private:
+    struct alignas(64) WorkRange {
+        std::mutex lock;
+        size_t next = 0;
+        size_t end = 0;
+    };
+
+    using Body = std::function<void(size_t, unsigned)>;
+
+    static constexpr size_t kChunk = 4;
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<WorkRange[]> ranges;
+    unsigned thread_count;
+
+    std::mutex submit_lock;     // held by the caller whose job owns ranges and job
+    std::mutex state_lock;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const Body* job = nullptr;
+    size_t job_id = 0;
+    unsigned active = 0;
+    bool stopping = false;
+
+public:
+    explicit WorkStealingPool(unsigned threads = std::thread::hardware_concurrency())
+        : ranges(new WorkRange[std::max(threads, 1u)]), thread_count(std::max(threads, 1u)) {
+        // The calling thread acts as worker 0, so only thread_count - 1 threads are spawned
+        for (unsigned id = 1; id < thread_count; ++id) {
+            workers.emplace_back([this, id] { workerLoop(id); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> guard(state_lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const {
+        return thread_count;
+    }
+
+    // Run body(i, worker) for every i in [0, count) and return once all calls have finished
+    void parallelFor(size_t count, const Body& body) {
+        if (count == 0) return;
+        if (thread_count == 1 || count == 1 || currentPool() == this) {
+            unsigned worker = currentPool() == this ? currentWorker() : 0;
+            for (size_t i = 0; i < count; ++i) body(i, worker);
+            return;
+        }
+        std::lock_guard<std::mutex> submit(submit_lock);
+        for (unsigned id = 0; id < thread_count; ++id) {
+            std::lock_guard<std::mutex> guard(ranges[id].lock);
+            ranges[id].next = count * id / thread_count;
+            ranges[id].end = count * (id + 1) / thread_count;
+        }
+        {
+            std::lock_guard<std::mutex> guard(state_lock);
+            job = &body;
+            ++job_id;
+            active = thread_count - 1;
+        }
+        wake.notify_all();
+        {
+            WorkerScope scope(this, 0);
+            runJob(0, body);
+        }
+
+        std::unique_lock<std::mutex> guard(state_lock);
+        done.wait(guard, [this] { return active == 0; });
+        job = nullptr;
+    }
+
+    // Run body(i) for every i in [0, count)
+    void parallelFor(size_t count, const std::function<void(size_t)>& body) {
+        parallelFor(count, Body([&body](size_t i, unsigned) { body(i); }));
+    }
+
+private:
+    // Marks the current thread as worker id of this pool while it runs a job
+    class WorkerScope {
+    public:
+        WorkerScope(const WorkStealingPool* pool, unsigned id) : saved_pool(currentPool()), saved_worker(currentWorker()) {
+            currentPool() = pool;
+            currentWorker() = id;
+        }
+
+        ~WorkerScope() {
+            currentPool() = saved_pool;
+            currentWorker() = saved_worker;
+        }
+
+    private:
+        const WorkStealingPool* saved_pool;
+        unsigned saved_worker;
+    };
+
+    static const WorkStealingPool*& currentPool() {
+        thread_local const WorkStealingPool* pool = nullptr;
+        return pool;
+    }
+
+    static unsigned& currentWorker() {
+        thread_local unsigned worker = 0;
+        return worker;
+    }
+
+    void workerLoop(unsigned id) {
+        WorkerScope scope(this, id);
+        size_t seen_job = 0;
+        while (true) {
+            const Body* body;
+            {
+                std::unique_lock<std::mutex> guard(state_lock);
+                wake.wait(guard, [&] { return stopping || job_id != seen_job; });
+                if (stopping) return;
+                seen_job = job_id;
+                body = job;
+            }
+            runJob(id, *body);
+            {
+                std::lock_guard<std::mutex> guard(state_lock);
+                --active;
+            }
+            done.notify_one();
+        }
+    }
+
+    void runJob(unsigned id, const Body& body) {
+        while (true) {
+            size_t begin, end;
+            if (!takeLocal(id, begin, end)) {
+                if (!steal(id)) return;
+                continue;
+            }
+            for (size_t i = begin; i < end; ++i) body(i, id);
+        }
+    }
+
+    bool takeLocal(unsigned id, size_t& begin, size_t& end) {
+        WorkRange& own = ranges[id];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (own.next >= own.end) return false;
+        begin = own.next;
+        end = std::min(own.next + kChunk, own.end);
+        own.next = end;
+        return true;
+    }
+
+    // Move the back half of some other worker's remaining range into our own
+    bool steal(unsigned id) {
+        for (unsigned k = 1; k < thread_count; ++k) {
+            WorkRange& victim = ranges[(id + k) % thread_count];
+            size_t begin, end;
+            {
+                std::lock_guard<std::mutex> guard(victim.lock);
+                if (victim.next >= victim.end) continue;
+                size_t mid = victim.next + (victim.end - victim.next) / 2;
+                begin = mid;
+                end = victim.end;
+                victim.end = mid;
+            }
+            WorkRange& own = ranges[id];
+            std::lock_guard<std::mutex> guard(own.lock);
+            own.next = begin;
+            own.end = end;
+            return true;
+        }
+        return false;
+    }
+};
+
+// Lock-free union-find over dense ids for connectivity queries. Storage grows in chunks of
+// doubling size that are published with a CAS, so ids can be added while other threads unite
+// and query. Roots are linked by a fixed pseudo-random priority and finds halve paths with CAS;
+// both only ever move a node closer to its root, so concurrent calls stay consistent.
+class ConcurrentUnionFind {
+private:
+    static constexpr int kFirstChunkBits = 10;
+    static constexpr int kChunkCount = 22;          // enough for every non-negative int id
+
+    mutable std::atomic<std::atomic<int>*> chunks[kChunkCount];
+
+public:
+    ConcurrentUnionFind() {
+        for (auto& chunk : chunks) chunk.store(nullptr, std::memory_order_relaxed);
+    }
+
+    // Copies are snapshots and must not race with writers
+    ConcurrentUnionFind(const ConcurrentUnionFind& other) : ConcurrentUnionFind() {
+        *this = other;
+    }
+
+    ConcurrentUnionFind& operator=(const ConcurrentUnionFind& other) {
+        if (this == &other) return *this;
+        clear();
+        for (int k = 0; k < kChunkCount; ++k) {
+            const std::atomic<int>* source = other.chunks[k].load(std::memory_order_acquire);
+            if (!source) continue;
+            size_t size = chunkSize(k);
+            std::atomic<int>* chunk = new std::atomic<int>[size];
+            for (size_t i = 0; i < size; ++i) chunk[i].store(source[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            chunks[k].store(chunk, std::memory_order_release);
+        }
+        return *this;
+    }
+
+    ~ConcurrentUnionFind() {
+        clear();
+    }
+
+    void clear() {
+        for (auto& chunk : chunks) delete[] chunk.exchange(nullptr);
+    }
+
+    // Make id usable as a singleton set; safe to call concurrently
+    void add(int id) {
+        int k = chunkOf(id);
+        if (chunks[k].load(std::memory_order_acquire)) return;
+        size_t size = chunkSize(k);
+        int first = chunkStart(k);
+        std::atomic<int>* chunk = new std::atomic<int>[size];
+        for (size_t i = 0; i < size; ++i) chunk[i].store(first + static_cast<int>(i), std::memory_order_relaxed);
+        std::atomic<int>* expected = nullptr;
+        if (!chunks[k].compare_exchange_strong(expected, chunk, std::memory_order_acq_rel)) delete[] chunk;
+    }
+
+    int find(int id) const {
+        while (true) {
+            std::atomic<int>* slot = parentSlot(id);
+            if (!slot) return id;
+            int parent = slot->load(std::memory_order_acquire);
+            if (parent == id) return id;
+            int grandparent = parentSlot(parent)->load(std::memory_order_acquire);
+            if (grandparent != parent) slot->compare_exchange_weak(parent, grandparent, std::memory_order_acq_rel);
+            id = grandparent;
+        }
+    }
+
+    void unite(int a, int b) {
+        add(a);
+        add(b);
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return;
+            if (priority(a) > priority(b)) std::swap(a, b);
+            // Fails only if a stopped being a root in the meantime; then start over from it
+            int expected = a;
+            if (parentSlot(a)->compare_exchange_strong(expected, b, std::memory_order_acq_rel)) return;
+        }
+    }
+
+    // A root seen by find may be linked concurrently, so equal roots are the only proof and
+    // differing roots count only if the first is still a root afterwards
+    bool connected(int a, int b) const {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return true;
+            std::atomic<int>* slot = parentSlot(a);
+            if (!slot || slot->load(std::memory_order_acquire) == a) return false;
+        }
+    }
+
+    size_t memoryBytes() const {
+        size_t bytes = 0;
+        for (int k = 0; k < kChunkCount; ++k) {
+            if (chunks[k].load(std::memory_order_relaxed)) bytes += chunkSize(k) * sizeof(std::atomic<int>);
+        }
+        return bytes;
+    }
+
+private:
+    // Chunk k holds ids [1024 * (2^k - 1), 1024 * (2^(k+1) - 1))
+    static int chunkOf(int id) {
+        uint64_t q = (static_cast<uint64_t>(id) >> kFirstChunkBits) + 1;
+#ifdef _MSC_VER
+        unsigned long k;
+        _BitScanReverse64(&k, q);
+        return static_cast<int>(k);
+#else
+        return 63 - __builtin_clzll(q);
+#endif
+    }
+
+    static int chunkStart(int k) {
+        return static_cast<int>(((uint64_t(1) << k) - 1) << kFirstChunkBits);
+    }
+
+    static size_t chunkSize(int k) {
+        return size_t(1) << (k + kFirstChunkBits);
+    }
+
+    std::atomic<int>* parentSlot(int id) const {
+        int k = chunkOf(id);
+        std::atomic<int>* chunk = chunks[k].load(std::memory_order_acquire);
+        return chunk ? chunk + (id - chunkStart(k)) : nullptr;
+    }
+
+    // Bijective mix of the id, so priorities never tie
+    static uint32_t priority(int id) {
+        uint32_t x = static_cast<uint32_t>(id);
+        x ^= x >> 16;
+        x *= 0x7feb352dU;
+        x ^= x >> 15;
+        x *= 0x846ca68bU;
+        x ^= x >> 16;
+        return x;
+    }
+};
+
+// ------------------------ Edge-List Parsing ------------------------
+// Helpers for the text loaders: a file is cut into chunks on line boundaries and every chunk is
+// parsed on its own thread, with integers read eight digits at a time when they are that long.
+
+// Index of the lowest set bit; bits must be non-zero
+inline int countTrailingZeros(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// Number of set bits
+inline int countSetBits(uint64_t bits) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(bits));
+#else
+    return __builtin_popcountll(bits);
+#endif
+}
+
+// Start of chunk i when the file is cut every chunk_bytes and each cut is moved just past the next
+// newline, so every line belongs to exactly one chunk; chunk i ends where chunk i + 1 starts
+inline size_t lineChunkStart(const char* data, size_t size, size_t chunk_bytes, size_t i) {
+    if (i == 0) return 0;
+    size_t cut = i * chunk_bytes;
+    if (cut >= size) return size;
+    const void* newline = std::memchr(data + cut - 1, '\n', size - cut + 1);
+    return newline ? static_cast<size_t>(static_cast<const char*>(newline) - data) + 1 : size;
+}
+
+// True if all eight bytes are ASCII digits
+inline bool eightDigits(uint64_t word) {
+    return ((word & 0xF0F0F0F0F0F0F0F0ull) | (((word + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) ==
+           0x3333333333333333ull;
+}
+
+// Value of eight ASCII digits loaded little-endian, combined pairwise with three multiplies
+inline uint32_t eightDigitValue(uint64_t word) {
+    word -= 0x3030303030303030ull;
+    word = word * 10 + (word >> 8);
+    word = ((word & 0x000000FF000000FFull) * 0x000F424000000064ull + ((word >> 16) & 0x000000FF000000FFull) * 0x0000271000000001ull) >> 32;
+    return static_cast<uint32_t>(word);
+}
+
+// Parse a signed decimal int at p and advance past it; false if there is none or it overflows
+inline bool parseInt(const char*& p, const char* end, int& value) {
+    bool negative = p < end && *p == '-';
+    if (p < end && (*p == '-' || *p == '+')) ++p;
+    const char* first = p;
+    const uint64_t limit = uint64_t(std::numeric_limits<int>::max()) + (negative ? 1 : 0);
+    uint64_t result = 0;
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t word;
+    while (end - p >= 8 && (std::memcpy(&word, p, 8), eightDigits(word))) {
+        result = result * 100000000 + eightDigitValue(word);
+        p += 8;
+        if (result > limit) return false;
+    }
+#endif
+    while (p < end && static_cast<unsigned>(*p - '0') < 10) {
+        result = result * 10 + static_cast<unsigned>(*p - '0');
+        ++p;
+        if (result > limit) return false;
+    }
+    if (p == first) return false;
+    value = negative ? static_cast<int>(-static_cast<int64_t>(result)) : static_cast<int>(result);
+    return true;
+}
+
+inline bool isSeparator(char c) {
+    return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+// Skip field separators: blanks, tabs, commas and carriage returns
+inline void skipSeparators(const char*& p, const char* end) {
+    while (p < end && isSeparator(*p)) ++p;
+}
+
+// Calls parse_line(line_begin, line_end) for every line that is not blank or a '#' / '%' comment
+// and starts in [begin, end); stops early when it returns false
+template <class LineParser>
+inline void forEachDataLine(const char* data, size_t begin, size_t end, LineParser&& parse_line) {
+    const char* p = data + begin;
+    const char* stop = data + end;
+    while (p < stop) {
+        const char* line = p;
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', stop - p));
+        const char* line_end = newline ? newline : stop;
+        p = newline ? newline + 1 : stop;
+        const char* q = line;
+        skipSeparators(q, line_end);
+        if (q == line_end || *q == '#' || *q == '%') continue;
+        if (!parse_line(line, line_end)) return;
+    }
+}
+
+// Return the sorted distinct labels of all parsed endpoints and replace every endpoint by its
+// index among them. A label range not much larger than the edge count is marked in a shared
+// bitmap, and an index is the count of set bits before the label's bit. Sparse labels are sorted
+// per chunk, merged pairwise and found by binary search. A chunk has the parsed endpoints and
+// their low / high label.
+template <class EdgeChunk>
+std::vector<int> relabelEndpoints(std::vector<EdgeChunk>& chunks, WorkStealingPool& pool) {
+    constexpr size_t kWordBlock = 4096;    // bitmap words per task
+    int low = std::numeric_limits<int>::max(), high = std::numeric_limits<int>::min();
+    size_t endpoint_count = 0;
+    for (const EdgeChunk& chunk : chunks) {
+        low = std::min(low, chunk.low);
+        high = std::max(high, chunk.high);
+        endpoint_count += chunk.endpoints.size();
+    }
+    if (endpoint_count == 0) return {};
+    std::vector<int> labels;
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(high) - low) + 1;
+
+    if (range <= 8 * endpoint_count + 4096) {
+        size_t words = static_cast<size_t>((range + 63) / 64);
+        std::unique_ptr<std::atomic<uint64_t>[]> present(new std::atomic<uint64_t>[words]);
+        for (size_t w = 0; w < words; ++w) present[w].store(0, std::memory_order_relaxed);
+        pool.parallelFor(chunks.size(), [&](size_t i) {
+            for (int endpoint : chunks[i].endpoints) {
+                uint64_t offset = static_cast<uint64_t>(static_cast<int64_t>(endpoint) - low);
+                uint64_t bit = uint64_t(1) << (offset & 63);
+                if (!(present[offset >> 6].load(std::memory_order_relaxed) & bit)) present[offset >> 6].fetch_or(bit, std::memory_order_relaxed);
+            }
+        });
+        size_t blocks = (words + kWordBlock - 1) / kWordBlock;
+        std::vector<size_t> block_start(blocks + 1, 0);
+        pool.parallelFor(blocks, [&](size_t block) {
+            size_t total = 0;
+            for (size_t w = block * kWordBlock; w < std::min(words, (block + 1) * kWordBlock); ++w) {
+                total += countSetBits(present[w].load(std::memory_order_relaxed));
+            }
+            block_start[block + 1] = total;
+        });
+        for (size_t block = 0; block < blocks; ++block) block_start[block + 1] += block_start[block];
+        labels.resize(block_start[blocks]);
+        std::vector<int> word_rank(words);
+        pool.parallelFor(blocks, [&](size_t block) {
+            size_t out = block_start[block];
+            for (size_t w = block * kWordBlock; w < std::min(words, (block + 1) * kWordBlock); ++w) {
+                word_rank[w] = static_cast<int>(out);
+                for (uint64_t bits = present[w].load(std::memory_order_relaxed); bits != 0; bits &= bits - 1) {
+                    labels[out++] = static_cast<int>(low + static_cast<int64_t>(w * 64 + countTrailingZeros(bits)));
+                }
+            }
+        });
+        pool.parallelFor(chunks.size(), [&](size_t i) {
+            for (int& endpoint : chunks[i].endpoints) {
+                uint64_t offset = static_cast<uint64_t>(static_cast<int64_t>(endpoint) - low);
+                uint64_t below = present[offset >> 6].load(std::memory_order_relaxed) & ((uint64_t(1) << (offset & 63)) - 1);
+                endpoint = word_rank[offset >> 6] + countSetBits(below);
+            }
+        });
+        return labels;
+    }
+
+    std::vector<std::vector<int>> runs(chunks.size());
+    pool.parallelFor(chunks.size(), [&](size_t i) {
+        runs[i] = chunks[i].endpoints;
+        std::sort(runs[i].begin(), runs[i].end());
+        runs[i].erase(std::unique(runs[i].begin(), runs[i].end()), runs[i].end());
+    });
+    for (size_t width = 1; width < runs.size(); width *= 2) {
+        pool.parallelFor((runs.size() + 2 * width - 1) / (2 * width), [&](size_t pair) {
+            size_t left = pair * 2 * width, right = left + width;
+            if (right >= runs.size()) return;
+            std::vector<int> merged;
+            merged.reserve(runs[left].size() + runs[right].size());
+            std::set_union(runs[left].begin(), runs[left].end(), runs[right].begin(), runs[right].end(), std::back_inserter(merged));
+            runs[left].swap(merged);
+            std::vector<int>().swap(runs[right]);
+        });
+    }
+    labels.swap(runs[0]);
+    pool.parallelFor(chunks.size(), [&](size_t i) {
+        for (int& endpoint : chunks[i].endpoints) {
+            endpoint = static_cast<int>(std::lower_bound(labels.begin(), labels.end(), endpoint) - labels.begin());
+        }
+    });
+    return labels;
+}
+
+// True if offsets[0] == 0, offsets never decreases, offsets[n] == slots and, when targets is
+// given, every target is in [0, n). Meant for arrays mapped from a file, which nothing may index
+// until they pass; checked in parallel blocks, each of which bounds its own offsets before it
+// reads a target.
+inline bool validCsr(const int* offsets, const int* targets, int n, uint64_t slots, WorkStealingPool& pool) {
+    constexpr size_t kNodeBlock = 4096;
+    if (offsets[0] != 0 || offsets[n] < 0 || static_cast<uint64_t>(offsets[n]) != slots) return false;
+    std::atomic<bool> valid{true};
+    pool.parallelFor((static_cast<size_t>(n) + kNodeBlock - 1) / kNodeBlock, [&](size_t block) {
+        int first = static_cast<int>(block * kNodeBlock);
+        int last = static_cast<int>(std::min<size_t>(n, (block + 1) * kNodeBlock));
+        for (int v = first; v < last; ++v) {
+            if (offsets[v] < 0 || offsets[v] > offsets[v + 1] || offsets[v + 1] > offsets[n]) {
+                valid.store(false, std::memory_order_relaxed);
+                return;
+            }
+        }
+        if (!targets) return;
+        for (int e = offsets[first]; e < offsets[last]; ++e) {
+            if (static_cast<unsigned>(targets[e]) >= static_cast<unsigned>(n)) {
+                valid.store(false, std::memory_order_relaxed);
+                return;
+            }
+        }
+    });
+    return valid.load();
+}
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+private:
+    const char* base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        close();
+    }
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+            close();
+            return false;
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            close();
+            return false;
+        }
+        base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (base == nullptr) {
+            close();
+            return false;
+        }
+        length = static_cast<size_t>(file_size.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (address == MAP_FAILED) return false;
+        base = static_cast<const char*>(address);
+        length = static_cast<size_t>(info.st_size);
+#endif
+        return true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (base != nullptr) UnmapViewOfFile(base);
+        if (mapping != nullptr) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        mapping = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        if (base != nullptr) munmap(const_cast<char*>(base), length);
+#endif
+        base = nullptr;
+        length = 0;
+    }
+
+    const char* data() const {
+        return base;
+    }
+
+    size_t size() const {
+        return length;
+    }
+};
+
+}  // namespace search_common
+
+#ifdef SEARCH_STATS
+#define SEARCH_STAT_ADD(stats, field, amount) do { if (stats) (stats)->field += (amount); } while (0)
+#define SEARCH_STAT_MAX(stats, field, value) \
+    do { if (stats) (stats)->field = std::max<size_t>((stats)->field, (value)); } while (0)
+#define SEARCH_TIMER(stats, name) \
+    static search_common::LatencyHistogram& search_histogram = search_common::LatencyHistogram::named(name); \
+    search_common::SearchTimer search_timer(stats, search_histogram)
+#else
+#define SEARCH_STAT_ADD(stats, field, amount) ((void)(stats))
+#define SEARCH_STAT_MAX(stats, field, value) ((void)(stats))
+#define SEARCH_TIMER(stats, name) ((void)(stats))
+#endif
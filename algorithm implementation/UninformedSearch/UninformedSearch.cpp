@@ -1,173 +1,1772 @@
 #include <iostream>
 #include <unordered_map>
 #include <unordered_set>
+#include <set>
 #include <vector>
 #include <queue>
 #include <stack>
 #include <algorithm>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+#include "../SearchCommon/SearchCommon.hpp"
 
 using namespace std;
+using search_common::capacityBytes;
+using search_common::ConcurrentUnionFind;
+using search_common::countTrailingZeros;
+using search_common::forEachDataLine;
+using search_common::lineChunkStart;
+using search_common::parseInt;
+using search_common::relabelEndpoints;
+using search_common::skipSeparators;
+using search_common::validCsr;
+using search_common::LatencyHistogram;
+using search_common::MappedFile;
+using search_common::SearchStats;
+using search_common::WorkStealingPool;
+
+// On-disk layout written by save_binary and mapped by open_binary: sorted node labels, then the
+// CSR offsets and targets (as indices into labels). Sections are 8-byte aligned, native byte order.
+struct BinaryGraphHeader {
+    enum Section { Labels, Offsets, Targets, SectionCount };
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t node_count;
+    uint64_t edge_slots;    // length of targets, two per undirected edge
+    uint64_t section_offset[SectionCount];
+    uint64_t section_bytes[SectionCount];
+};
+
+// Result of parallel_bfs, by snapshot index (see index_of / label_of). Unreached nodes have
+// distance and parent -1; the source is its own parent.
+struct BfsTree {
+    int source = -1;
+    vector<int> distance;
+    vector<int> parent;
+};
+
+// How a DFS reached an edge's target. The graph is undirected, so each edge is seen from both
+// ends: a Tree edge is seen back from the child as Back (to its parent), and a Back edge to an
+// ancestor is seen again from that ancestor as Finished.
+enum class DfsEdge { Tree, Back, Finished };
+
+// Callbacks for Graph::depth_first, with vertices as snapshot indices. Derive from this and hide
+// the callbacks you need; calls are resolved at compile time, so unused ones cost nothing.
+struct DfsVisitor {
+    void discover(int) {}
+    void finish(int) {}
+    void edge(int, int, DfsEdge) {}
+};
+
+// Result of Graph::iterative_deepening: the path as node labels from start to target and its depth
+struct IdsResult {
+    bool found = false;
+    int depth = -1;
+    vector<int> path;
+};
 
 class Graph {
 public:
     unordered_map<int, unordered_set<int>> graph;
 
+private:
+    // Read-only CSR snapshot the traversals run on. Node i has label labels[i] (sorted ascending)
+    // and neighbors targets[offsets[i] .. offsets[i + 1]), also sorted. The pointers refer either to
+    // the owned arrays or straight into a file mapped by open_binary.
+    struct GraphSnapshot {
+        int node_count = 0;
+        const int* labels = nullptr;
+        const int* offsets = nullptr;
+        const int* targets = nullptr;
+
+        vector<int> label_store, offset_store, target_store;
+        shared_ptr<const MappedFile> mapping;
+
+        GraphSnapshot() = default;
+
+        GraphSnapshot(const GraphSnapshot& other) {
+            *this = other;
+        }
+
+        // Copies must point at their own storage, not at the source's
+        GraphSnapshot& operator=(const GraphSnapshot& other) {
+            if (this == &other) return *this;
+            node_count = other.node_count;
+            label_store = other.label_store;
+            offset_store = other.offset_store;
+            target_store = other.target_store;
+            mapping = other.mapping;
+            if (mapping) {
+                labels = other.labels;
+                offsets = other.offsets;
+                targets = other.targets;
+            } else {
+                bind_storage();
+            }
+            return *this;
+        }
+
+        void bind_storage() {
+            labels = label_store.data();
+            offsets = offset_store.data();
+            targets = target_store.data();
+        }
+    };
+
+    // Vertices a BFS worker found in one level, with their count and total degree; the
+    // bidirectional search also tracks the shortest meeting the worker saw
+    struct alignas(64) BfsLevelOutput {
+        vector<int> found;
+        size_t count = 0;
+        uint64_t degree = 0;
+        int best_length = 0;
+        int meeting = -1;
+    };
+
+    // One direction of bidirectional_bfs. parent and distance are only valid where the bit in
+    // seen is set, so they are left uninitialized; bits are claimed with fetch_or.
+    struct BidirectionalSide {
+        unique_ptr<atomic<uint64_t>[]> seen;
+        unique_ptr<int[]> parent;
+        unique_ptr<int[]> distance;
+        vector<int> frontier;
+        uint64_t frontier_edges = 0;
+        int depth = 0;
+
+        explicit BidirectionalSide(int n)
+            : seen(new atomic<uint64_t>[(n + 63) / 64]), parent(new int[n]), distance(new int[n]) {
+            for (int w = 0; w < (n + 63) / 64; ++w) seen[w].store(0, memory_order_relaxed);
+        }
+
+        void seed(int v, uint64_t edges) {
+            claim(v);
+            parent[v] = v;
+            distance[v] = 0;
+            frontier.push_back(v);
+            frontier_edges = edges;
+        }
+
+        bool contains(int v) const {
+            return seen[v >> 6].load(memory_order_relaxed) >> (v & 63) & 1;
+        }
+
+        // True if this call added v
+        bool claim(int v) {
+            uint64_t bit = uint64_t(1) << (v & 63);
+            if (seen[v >> 6].load(memory_order_relaxed) & bit) return false;
+            return !(seen[v >> 6].fetch_or(bit, memory_order_relaxed) & bit);
+        }
+
+        size_t memory_bytes(int n) const {
+            return (n + 63) / 64 * sizeof(uint64_t) + 2 * static_cast<size_t>(n) * sizeof(int) + capacityBytes(frontier);
+        }
+    };
+
+    // Dense discovered and finished bitsets plus the explicit stack of (vertex, next edge) frames
+    struct DfsState {
+        vector<uint64_t> discovered_bits;
+        vector<uint64_t> finished_bits;
+        vector<pair<int, int>> stack;
+
+        explicit DfsState(int n) : discovered_bits((n + 63) / 64, 0), finished_bits((n + 63) / 64, 0) {}
+
+        bool discovered(int v) const {
+            return discovered_bits[v >> 6] >> (v & 63) & 1;
+        }
+
+        bool finished(int v) const {
+            return finished_bits[v >> 6] >> (v & 63) & 1;
+        }
+
+        size_t memory_bytes() const {
+            return capacityBytes(discovered_bits) + capacityBytes(finished_bits) + capacityBytes(stack);
+        }
+    };
+
+    GraphSnapshot csr;
+    bool frozen = false;
+
+    // Connected components, kept up to date by add_edges so searches can reject a target in
+    // another component without exploring anything. Ids are dense per label in insertion order,
+    // or the snapshot index for a mapped or loaded graph.
+    ConcurrentUnionFind components;
+    unordered_map<int, int> component_ids;
+    bool components_by_index = false;
+
+    // One line-aligned chunk of a parsed edge list: (u, v) label pairs, their label range and,
+    // on a malformed line, its file offset
+    struct EdgeChunk {
+        vector<int> endpoints;
+        int low = numeric_limits<int>::max();
+        int high = numeric_limits<int>::min();
+        size_t error = numeric_limits<size_t>::max();
+    };
+
+    static constexpr uint32_t kBinaryVersion = 1;
+    static constexpr size_t kBfsBlock = 256;       // queue entries or vertices per parallel_bfs task
+    static constexpr size_t kBfsWordBlock = 16;    // bitmap words per bottom-up task
+    static constexpr uint64_t kBfsAlpha = 14;
+    static constexpr size_t kBfsBeta = 24;
+    static constexpr size_t kLoadChunkBytes = size_t(4) << 20;    // minimum edge-list text per parse task
+    static constexpr size_t kLoadVertexBlock = 4096;              // vertices or words per load task
+
+public:
     // Add undirected edge
     void add_edges(int u, int v) {
+        if (csr.mapping) {
+            cerr << "Graph is memory-mapped from a binary file and cannot be modified" << endl;
+            return;
+        }
+        if (components_by_index) thaw();
         graph[u].insert(v);
         graph[v].insert(u);
+        components.unite(component_id(u), component_id(v));
+        frozen = false;
+    }
+
+    // Whether a path can exist between two labels; O(alpha(n))
+    bool connected(int u, int v) const {
+        if (u == v) return true;
+        int a, b;
+        if (components_by_index) {
+            a = index_of(u);
+            b = index_of(v);
+        } else {
+            auto first = component_ids.find(u), second = component_ids.find(v);
+            a = first == component_ids.end() ? -1 : first->second;
+            b = second == component_ids.end() ? -1 : second->second;
+        }
+        return a != -1 && b != -1 && components.connected(a, b);
+    }
+
+    // Build the CSR snapshot from the adjacency sets; traversals call this on demand
+    void freeze() {
+        if (frozen) return;
+        vector<int>& labels = csr.label_store;
+        labels.clear();
+        for (const auto& pair : graph) labels.push_back(pair.first);
+        sort(labels.begin(), labels.end());
+        int n = static_cast<int>(labels.size());
+
+        csr.node_count = n;
+        csr.offset_store.assign(n + 1, 0);
+        csr.target_store.clear();
+        csr.labels = labels.data();
+        for (int i = 0; i < n; ++i) {
+            size_t first = csr.target_store.size();
+            for (int neighbor : graph[labels[i]]) csr.target_store.push_back(index_of(neighbor));
+            sort(csr.target_store.begin() + first, csr.target_store.end());
+            csr.offset_store[i + 1] = static_cast<int>(csr.target_store.size());
+        }
+        csr.bind_storage();
+        frozen = true;
+    }
+
+    int node_count() const {
+        return csr.node_count;
+    }
+
+    int label_of(int index) const {
+        return csr.labels[index];
+    }
+
+    // Dense index of a node label in the snapshot, or -1 if absent
+    int index_of(int label) const {
+        const int* last = csr.labels + csr.node_count;
+        const int* it = lower_bound(csr.labels, last, label);
+        return it != last && *it == label ? static_cast<int>(it - csr.labels) : -1;
+    }
+
+    // Write the snapshot for open_binary
+    bool save_binary(const string& path) {
+        freeze();
+        int n = node_count();
+        uint64_t slots = csr.offsets[n];
+
+        BinaryGraphHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "UGRAPH\0", 8);
+        header.version = kBinaryVersion;
+        header.byte_order = 0x01020304;
+        header.node_count = n;
+        header.edge_slots = slots;
+
+        const int* sections[BinaryGraphHeader::SectionCount] = {csr.labels, csr.offsets, csr.targets};
+        uint64_t sizes[BinaryGraphHeader::SectionCount] = {n * sizeof(int), (n + 1) * sizeof(int), slots * sizeof(int)};
+        uint64_t position = align_to_8(sizeof(header));
+        for (int i = 0; i < BinaryGraphHeader::SectionCount; ++i) {
+            header.section_offset[i] = position;
+            header.section_bytes[i] = sizes[i];
+            position = align_to_8(position + sizes[i]);
+        }
+
+        ofstream out(path, ios::binary | ios::trunc);
+        if (!out) {
+            cerr << "Cannot write graph file " << path << endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (int i = 0; i < BinaryGraphHeader::SectionCount; ++i) {
+            pad_to(out, header.section_offset[i]);
+            if (sizes[i] > 0) out.write(reinterpret_cast<const char*>(sections[i]), sizes[i]);
+        }
+        pad_to(out, position);
+        return static_cast<bool>(out);
+    }
+
+    // Replace this graph with an undirected edge list, one "u v" pair of integer labels per line
+    // separated by blanks, tabs or commas; further columns (e.g. a cost) are ignored. Blank lines
+    // and lines starting with '#' or '%' are skipped, and so is a first line that does not start
+    // with a number (a CSV header). The file is mapped and parsed in line-aligned chunks on every
+    // pool thread, and the CSR snapshot is built directly by a parallel counting sort, without
+    // touching the adjacency sets; they are only filled in if the graph is edited afterwards.
+    bool load_edge_list(const string& path) {
+        return load_edge_list(path, shared_pool());
+    }
+
+    bool load_edge_list(const string& path, WorkStealingPool& pool) {
+        MappedFile file;
+        if (!file.open(path)) {
+            cerr << "Cannot open edge list " << path << endl;
+            return false;
+        }
+        const char* data = file.data();
+        size_t size = file.size();
+        // A few chunks per thread for balance, but no more, since the sort keeps a slice per chunk
+        size_t chunk_bytes = max(kLoadChunkBytes, size / (8 * pool.size()) + 1);
+        size_t chunk_count = (size + chunk_bytes - 1) / chunk_bytes;
+        vector<EdgeChunk> chunks(chunk_count);
+        pool.parallelFor(chunk_count, [&](size_t i, unsigned) {
+            size_t begin = lineChunkStart(data, size, chunk_bytes, i);
+            size_t end = lineChunkStart(data, size, chunk_bytes, i + 1);
+            parse_edge_chunk(data, begin, end, chunks[i]);
+        });
+
+        size_t error = numeric_limits<size_t>::max();
+        for (const EdgeChunk& chunk : chunks) error = min(error, chunk.error);
+        if (error != numeric_limits<size_t>::max()) {
+            cerr << "Malformed edge at line " << count(data, data + error, '\n') + 1 << " of " << path << endl;
+            return false;
+        }
+
+        vector<int> labels = relabelEndpoints(chunks, pool);
+        int n = static_cast<int>(labels.size());
+
+        // Two-pass parallel counting sort with no shared counters. Pass one moves every directed
+        // edge into the bucket of kLoadVertexBlock consecutive sources it starts at, each chunk
+        // writing to its own precomputed slice of every bucket; pass two sorts a bucket by source
+        // in cache, then sorts and deduplicates each neighbor list.
+        size_t buckets = (static_cast<size_t>(n) + kLoadVertexBlock - 1) / kLoadVertexBlock;
+        vector<size_t> slice(buckets * chunk_count + 1, 0);    // bucket-major, chunk-minor
+        pool.parallelFor(chunk_count, [&](size_t i, unsigned) {
+            const vector<int>& endpoints = chunks[i].endpoints;
+            for (size_t e = 0; e < endpoints.size(); e += 2) {
+                ++slice[endpoints[e] / kLoadVertexBlock * chunk_count + i + 1];
+                if (endpoints[e] != endpoints[e + 1]) ++slice[endpoints[e + 1] / kLoadVertexBlock * chunk_count + i + 1];
+            }
+        });
+        for (size_t k = 0; k < buckets * chunk_count; ++k) slice[k + 1] += slice[k];
+        vector<uint64_t> staged(slice.back());                 // (source within bucket << 32) | target
+        pool.parallelFor(chunk_count, [&](size_t i, unsigned) {
+            vector<size_t> next(buckets);
+            for (size_t bucket = 0; bucket < buckets; ++bucket) next[bucket] = slice[bucket * chunk_count + i];
+            auto place = [&](int u, int v) {
+                staged[next[u / kLoadVertexBlock]++] = uint64_t(u % kLoadVertexBlock) << 32 | static_cast<uint32_t>(v);
+            };
+            const vector<int>& endpoints = chunks[i].endpoints;
+            for (size_t e = 0; e < endpoints.size(); e += 2) {
+                place(endpoints[e], endpoints[e + 1]);
+                if (endpoints[e] != endpoints[e + 1]) place(endpoints[e + 1], endpoints[e]);
+            }
+            vector<int>().swap(chunks[i].endpoints);
+        });
+
+        vector<int> offsets(n + 1, 0);
+        offsets[n] = static_cast<int>(staged.size());
+        vector<int> slots(staged.size());
+        vector<int> degrees(n + 1, 0);
+        pool.parallelFor(buckets, [&](size_t bucket, unsigned) {
+            size_t begin = slice[bucket * chunk_count], end = slice[(bucket + 1) * chunk_count];
+            int first_vertex = static_cast<int>(bucket * kLoadVertexBlock);
+            int count = static_cast<int>(min<size_t>(n - first_vertex, kLoadVertexBlock));
+            vector<size_t> next(count + 1, 0);
+            for (size_t k = begin; k < end; ++k) ++next[(staged[k] >> 32) + 1];
+            for (int v = 0; v < count; ++v) next[v + 1] += next[v];
+            for (int v = 0; v < count; ++v) offsets[first_vertex + v] = static_cast<int>(begin + next[v]);
+            for (size_t k = begin; k < end; ++k) slots[begin + next[staged[k] >> 32]++] = static_cast<int>(staged[k] & 0xffffffffu);
+            // next[v] is now where vertex v ends, i.e. where v + 1 starts
+            for (int v = 0; v < count; ++v) {
+                auto first = slots.begin() + (v == 0 ? begin : begin + next[v - 1]);
+                auto last = slots.begin() + begin + next[v];
+                sort(first, last);
+                degrees[first_vertex + v + 1] = static_cast<int>(unique(first, last) - first);
+            }
+        });
+        vector<EdgeChunk>().swap(chunks);
+        vector<uint64_t>().swap(staged);
+
+        running_sum(degrees, pool);
+        vector<int> targets(degrees[n]);
+        pool.parallelFor(buckets, [&](size_t block, unsigned) {
+            int last = static_cast<int>(min<size_t>(n, (block + 1) * kLoadVertexBlock));
+            for (int v = static_cast<int>(block * kLoadVertexBlock); v < last; ++v) {
+                copy(slots.begin() + offsets[v], slots.begin() + offsets[v] + (degrees[v + 1] - degrees[v]), targets.begin() + degrees[v]);
+            }
+        });
+
+        graph.clear();
+        csr = GraphSnapshot();
+        csr.node_count = n;
+        csr.label_store = move(labels);
+        csr.offset_store = move(degrees);
+        csr.target_store = move(targets);
+        csr.bind_storage();
+        frozen = true;
+        index_components(pool);
+        return true;
+    }
+
+    // Replace this graph with a file written by save_binary; the arrays are used in place from the
+    // mapping, so no parsing or copying happens. The graph is read-only afterwards.
+    bool open_binary(const string& path) {
+        auto file = make_shared<MappedFile>();
+        if (!file->open(path)) {
+            cerr << "Cannot open graph file " << path << endl;
+            return false;
+        }
+        const char* base = file->data();
+        size_t file_size = file->size();
+        BinaryGraphHeader header;
+        bool valid = file_size >= sizeof(header);
+        if (valid) {
+            // Both counts are stored in int offsets, which also keeps the section sizes below from overflowing
+            const uint64_t max_count = static_cast<uint64_t>(numeric_limits<int>::max());
+            memcpy(&header, base, sizeof(header));
+            valid = memcmp(header.magic, "UGRAPH\0", 8) == 0 && header.version == kBinaryVersion &&
+                    header.byte_order == 0x01020304 && header.node_count < max_count && header.edge_slots <= max_count;
+        }
+        if (valid) {
+            uint64_t n = header.node_count;
+            uint64_t expected[BinaryGraphHeader::SectionCount] = {n * sizeof(int), (n + 1) * sizeof(int), header.edge_slots * sizeof(int)};
+            for (int i = 0; i < BinaryGraphHeader::SectionCount && valid; ++i) {
+                valid = header.section_bytes[i] == expected[i] && header.section_offset[i] % 8 == 0 &&
+                        header.section_offset[i] <= file_size && file_size - header.section_offset[i] >= expected[i];
+            }
+        }
+        GraphSnapshot mapped;
+        if (valid) {
+            mapped.node_count = static_cast<int>(header.node_count);
+            mapped.labels = reinterpret_cast<const int*>(base + header.section_offset[BinaryGraphHeader::Labels]);
+            mapped.offsets = reinterpret_cast<const int*>(base + header.section_offset[BinaryGraphHeader::Offsets]);
+            mapped.targets = reinterpret_cast<const int*>(base + header.section_offset[BinaryGraphHeader::Targets]);
+            mapped.mapping = file;
+            valid = valid_mapping(mapped, header.edge_slots, shared_pool());
+        }
+        if (!valid) {
+            cerr << "Invalid or incompatible graph file " << path << endl;
+            return false;
+        }
+
+        graph.clear();
+        csr = mapped;
+        frozen = true;
+        index_components(shared_pool());
+        return true;
     }
 
     // Print adjacency list
     void iterate() {
-        for (const auto& pair : graph) {
-            cout << pair.first << " -> : { ";
-            for (int neighbor : pair.second) {
-                cout << neighbor << " ";
+        freeze();
+        for (int i = 0; i < node_count(); ++i) {
+            cout << csr.labels[i] << " -> : { ";
+            for (int e = csr.offsets[i]; e < csr.offsets[i + 1]; ++e) {
+                cout << csr.labels[csr.targets[e]] << " ";
             }
             cout << "}" << endl;
         }
     }
 
     // BFS
-    void bfs(int start) {
-        unordered_set<int> visited;
+    void bfs(int start, SearchStats* stats = nullptr) {
+        SEARCH_TIMER(stats, "bfs");
+        freeze();
+        cout << "BFS traversal starting from node " << start << ": ";
+        int source = index_of(start);
+        if (source == -1) {
+            cout << start << " " << endl;
+            return;
+        }
+
+        vector<char> visited(node_count(), 0);
         queue<int> q;
-        visited.insert(start);
-        q.push(start);
+        visited[source] = 1;
+        q.push(source);
+        SEARCH_STAT_ADD(stats, pushes, 1);
 
-        cout << "BFS traversal starting from node " << start << ": ";
         while (!q.empty()) {
+            SEARCH_STAT_MAX(stats, peak_frontier, q.size());
             int vertex = q.front();
             q.pop();
-            cout << vertex << " ";
+            SEARCH_STAT_ADD(stats, pops, 1);
+            SEARCH_STAT_ADD(stats, expanded, 1);
+            SEARCH_STAT_ADD(stats, generated, csr.offsets[vertex + 1] - csr.offsets[vertex]);
+            cout << csr.labels[vertex] << " ";
 
-            vector<int> neighbors(graph[vertex].begin(), graph[vertex].end());
-            sort(neighbors.begin(), neighbors.end());
-            for (int neighbor : neighbors) {
-                if (visited.find(neighbor) == visited.end()) {
-                    visited.insert(neighbor);
+            // Neighbor lists are sorted in the snapshot, so no per-vertex sort is needed
+            for (int e = csr.offsets[vertex]; e < csr.offsets[vertex + 1]; ++e) {
+                int neighbor = csr.targets[e];
+                if (!visited[neighbor]) {
+                    visited[neighbor] = 1;
                     q.push(neighbor);
+                    SEARCH_STAT_ADD(stats, pushes, 1);
                 }
             }
         }
+        SEARCH_STAT_MAX(stats, peak_memory, capacityBytes(visited) + (stats ? stats->peak_frontier : 0) * sizeof(int));
         cout << endl;
     }
 
+    // Direction-optimizing parallel BFS (Beamer et al.) over the CSR snapshot. Levels are expanded
+    // top-down from a vertex queue while the frontier is small, and bottom-up (every unvisited
+    // vertex looks for a parent in the frontier bitmap) while the frontier's edges outnumber a
+    // 1/alpha share of the unexplored edges; it goes back to top-down once the frontier shrinks
+    // below n/beta vertices. The visited set is a bitmap whose bits are claimed with fetch_or.
+    BfsTree parallel_bfs(int start, SearchStats* stats = nullptr) {
+        freeze();
+        return parallel_bfs(start, shared_pool(), stats);
+    }
+
+    BfsTree parallel_bfs(int start, WorkStealingPool& pool, SearchStats* stats = nullptr) const {
+        SEARCH_TIMER(stats, "parallel_bfs");
+        const int n = node_count();
+        const size_t words = (static_cast<size_t>(n) + 63) / 64;
+        BfsTree tree;
+        tree.distance.resize(n);
+        tree.parent.resize(n);
+        pool.parallelFor((static_cast<size_t>(n) + kBfsBlock - 1) / kBfsBlock, [&](size_t block, unsigned) {
+            size_t end = min(static_cast<size_t>(n), (block + 1) * kBfsBlock);
+            for (size_t v = block * kBfsBlock; v < end; ++v) {
+                tree.distance[v] = -1;
+                tree.parent[v] = -1;
+            }
+        });
+        int source = index_of(start);
+        if (source == -1) return tree;
+        tree.source = source;
+        tree.distance[source] = 0;
+        tree.parent[source] = source;
+
+        unique_ptr<atomic<uint64_t>[]> visited(new atomic<uint64_t>[words]);
+        unique_ptr<atomic<uint64_t>[]> current_bits(new atomic<uint64_t>[words]);
+        unique_ptr<atomic<uint64_t>[]> next_bits(new atomic<uint64_t>[words]);
+        const size_t word_blocks = (words + kBfsWordBlock - 1) / kBfsWordBlock;
+        auto clear_bitmap = [&](atomic<uint64_t>* bitmap) {
+            pool.parallelFor(word_blocks, [&](size_t block, unsigned) {
+                size_t end = min(words, (block + 1) * kBfsWordBlock);
+                for (size_t w = block * kBfsWordBlock; w < end; ++w) bitmap[w].store(0, memory_order_relaxed);
+            });
+        };
+        clear_bitmap(visited.get());
+        visited[source / 64].store(uint64_t(1) << (source % 64), memory_order_relaxed);
+
+        vector<BfsLevelOutput> outputs(pool.size());
+        vector<int> queue = {source};
+        bool bottom_up = false, growing = true;
+        uint64_t frontier_edges = degree(source);
+        uint64_t unexplored_edges = static_cast<uint64_t>(csr.offsets[n]) - frontier_edges;
+        size_t frontier_size = 1;
+
+        for (int level = 0; frontier_size > 0; ++level) {
+            SEARCH_STAT_ADD(stats, expanded, frontier_size);
+            SEARCH_STAT_MAX(stats, peak_frontier, frontier_size);
+            size_t previous_size = frontier_size;
+            for (BfsLevelOutput& output : outputs) {
+                output.found.clear();
+                output.count = 0;
+                output.degree = 0;
+            }
+
+            // Pick the direction for this level and convert the frontier if it changes
+            if (!bottom_up && frontier_edges > unexplored_edges / kBfsAlpha) {
+                bottom_up = true;
+                clear_bitmap(current_bits.get());
+                pool.parallelFor((queue.size() + kBfsBlock - 1) / kBfsBlock, [&](size_t block, unsigned) {
+                    size_t end = min(queue.size(), (block + 1) * kBfsBlock);
+                    for (size_t i = block * kBfsBlock; i < end; ++i) {
+                        int v = queue[i];
+                        current_bits[v / 64].fetch_or(uint64_t(1) << (v % 64), memory_order_relaxed);
+                    }
+                });
+            } else if (bottom_up && !growing && frontier_size < static_cast<size_t>(n) / kBfsBeta) {
+                bottom_up = false;
+                pool.parallelFor(word_blocks, [&](size_t block, unsigned worker) {
+                    size_t end = min(words, (block + 1) * kBfsWordBlock);
+                    for (size_t w = block * kBfsWordBlock; w < end; ++w) {
+                        for (uint64_t bits = current_bits[w].load(memory_order_relaxed); bits; bits &= bits - 1) {
+                            outputs[worker].found.push_back(static_cast<int>(w * 64 + countTrailingZeros(bits)));
+                        }
+                    }
+                });
+                gather_queue(outputs, queue, pool);
+                for (BfsLevelOutput& output : outputs) output.found.clear();
+            }
+
+            if (bottom_up) {
+                pool.parallelFor(word_blocks, [&](size_t block, unsigned worker) {
+                    BfsLevelOutput& output = outputs[worker];
+                    size_t end = min(words, (block + 1) * kBfsWordBlock);
+                    for (size_t w = block * kBfsWordBlock; w < end; ++w) {
+                        uint64_t seen = visited[w].load(memory_order_relaxed);
+                        uint64_t unvisited = ~seen;
+                        if (w == words - 1 && n % 64) unvisited &= (uint64_t(1) << (n % 64)) - 1;
+                        uint64_t found = 0;
+                        for (; unvisited; unvisited &= unvisited - 1) {
+                            int v = static_cast<int>(w * 64 + countTrailingZeros(unvisited));
+                            for (int e = csr.offsets[v]; e < csr.offsets[v + 1]; ++e) {
+                                int u = csr.targets[e];
+                                if (!(current_bits[u / 64].load(memory_order_relaxed) >> (u % 64) & 1)) continue;
+                                tree.parent[v] = u;
+                                tree.distance[v] = level + 1;
+                                found |= uint64_t(1) << (v % 64);
+                                ++output.count;
+                                output.degree += degree(v);
+                                break;
+                            }
+                        }
+                        // This worker owns word w in every bitmap for the whole level
+                        next_bits[w].store(found, memory_order_relaxed);
+                        visited[w].store(seen | found, memory_order_relaxed);
+                    }
+                });
+                swap(current_bits, next_bits);
+            } else {
+                pool.parallelFor((queue.size() + kBfsBlock - 1) / kBfsBlock, [&](size_t block, unsigned worker) {
+                    BfsLevelOutput& output = outputs[worker];
+                    size_t end = min(queue.size(), (block + 1) * kBfsBlock);
+                    for (size_t i = block * kBfsBlock; i < end; ++i) {
+                        int u = queue[i];
+                        for (int e = csr.offsets[u]; e < csr.offsets[u + 1]; ++e) {
+                            int v = csr.targets[e];
+                            uint64_t bit = uint64_t(1) << (v % 64);
+                            if (visited[v / 64].load(memory_order_relaxed) & bit) continue;
+                            if (visited[v / 64].fetch_or(bit, memory_order_relaxed) & bit) continue;
+                            tree.parent[v] = u;
+                            tree.distance[v] = level + 1;
+                            output.found.push_back(v);
+                            ++output.count;
+                            output.degree += degree(v);
+                        }
+                    }
+                });
+                gather_queue(outputs, queue, pool);
+            }
+
+            frontier_size = 0;
+            frontier_edges = 0;
+            for (const BfsLevelOutput& output : outputs) {
+                frontier_size += output.count;
+                frontier_edges += output.degree;
+            }
+            unexplored_edges -= min(unexplored_edges, frontier_edges);
+            growing = frontier_size > previous_size;
+        }
+        SEARCH_STAT_MAX(stats, peak_memory, 3 * words * sizeof(uint64_t) + capacityBytes(queue) +
+                                                capacityBytes(tree.distance) + capacityBytes(tree.parent));
+        return tree;
+    }
+
+    static WorkStealingPool& shared_pool() {
+        static WorkStealingPool pool;
+        return pool;
+    }
+
     // DFS
-    void dfs(int node) {
-        unordered_set<int> visited;
+    void dfs(int node, SearchStats* stats = nullptr) {
+        SEARCH_TIMER(stats, "dfs");
+        freeze();
         cout << "DFS traversal starting from node " << node << ": ";
-        dfs_helper(node, visited);
+        int source = index_of(node);
+        if (source == -1) {
+            cout << node << " " << endl;
+            return;
+        }
+        struct PrintVisitor : DfsVisitor {
+            const int* labels;
+            void discover(int v) { cout << labels[v] << " "; }
+        } printer;
+        printer.labels = csr.labels;
+        depth_first(source, printer, stats);
         cout << endl;
     }
 
+    // Depth-first search from one snapshot index with an explicit stack, so chain depth is bounded
+    // only by memory. Neighbors are taken in snapshot (ascending label) order.
+    template <class Visitor>
+    void depth_first(int source, Visitor& visitor, SearchStats* stats = nullptr) const {
+        DfsState state(node_count());
+        depth_first_from(source, state, visitor, stats);
+        SEARCH_STAT_MAX(stats, peak_memory, state.memory_bytes());
+    }
+
+    // Depth-first forest over every vertex, rooted in index order (topological sort, SCC, ...)
+    template <class Visitor>
+    void depth_first_all(Visitor& visitor, SearchStats* stats = nullptr) const {
+        DfsState state(node_count());
+        for (int v = 0; v < node_count(); ++v) {
+            if (!state.discovered(v)) depth_first_from(v, state, visitor, stats);
+        }
+        SEARCH_STAT_MAX(stats, peak_memory, state.memory_bytes());
+    }
+
     // Depth-Limited DFS
-    bool depth_limited_dfs(int start, int target, int limit) {
+    bool depth_limited_dfs(int start, int target, int limit, SearchStats* stats = nullptr) {
+        SEARCH_TIMER(stats, "depth_limited_dfs");
         if (start == target) {
             cout << "Target Found!" << endl;
             return true;
         }
-        if (limit <= 0) {
+        if (!connected(start, target)) return false;
+        freeze();
+        int source = index_of(start), goal = index_of(target);
+        if (source == -1 || goal == -1) return false;
+        bool found = depth_limited_helper(source, goal, limit, 1, stats);
+        SEARCH_STAT_MAX(stats, peak_memory, (stats ? stats->peak_frontier : 0) * sizeof(int));
+        return found;
+    }
+
+    // Iterative Deepening Search
+    bool ids(int start, int target, int max_depth_limit, SearchStats* stats = nullptr) {
+        IdsResult result = iterative_deepening(start, target, max_depth_limit, stats);
+        if (!result.found) {
+            cout << "Target not found!" << endl;
             return false;
         }
-        for (int neighbor : graph[start]) {
-            if (depth_limited_dfs(neighbor, target, limit - 1)) {
-                return true;
-            }
-        }
-        return false;
+        cout << "Target Found at depth " << result.depth << ": ";
+        for (int label : result.path) cout << label << " ";
+        cout << endl;
+        return true;
     }
 
-    // Iterative Deepening Search
-    bool ids(int start, int target, int max_depth_limit) {
-        for (int depth = 0; depth <= max_depth_limit; ++depth) {
-            cout << "Depth Level : " << depth << endl;
-            bool found = depth_limited_dfs(start, target, depth);
-            if (found) {
-                cout << "Target Found at depth " << depth << endl;
-                return true;
+    // Iterative deepening with depth memo. shallowest[v] is the smallest depth v has been reached at
+    // in any level so far, i.e. the best remaining budget it has been seen with. A node reached
+    // deeper than that, or at that depth when it was already expanded in this level, is skipped,
+    // which also cuts cycles. The memo carries over between levels, so every node is expanded at
+    // most once per level, at its shortest depth. The search stops early once a level ends without
+    // any node being cut off by the limit. Stats accumulate over all levels.
+    IdsResult iterative_deepening(int start, int target, int max_depth, SearchStats* stats = nullptr) {
+        SEARCH_TIMER(stats, "ids");
+        IdsResult result;
+        if (max_depth < 0) return result;
+        // Found at depth 0 even for a label the graph does not contain, as bidirectional_bfs does
+        if (start == target) {
+            result.found = true;
+            result.depth = 0;
+            result.path.push_back(start);
+            return result;
+        }
+        if (!connected(start, target)) return result;
+        freeze();
+        int source = index_of(start), goal = index_of(target);
+        if (source == -1 || goal == -1) return result;
+
+        vector<int> shallowest(node_count(), numeric_limits<int>::max());
+        vector<int> expanded_in(node_count(), -1);
+        vector<pair<int, int>> stack;    // (vertex, next edge); a frame's depth is its index
+        shallowest[source] = 0;
+
+        for (int limit = 1; limit <= max_depth; ++limit) {
+            bool cut_off = false;
+            stack.clear();
+            stack.push_back({source, csr.offsets[source]});
+            expanded_in[source] = limit;
+            SEARCH_STAT_ADD(stats, pushes, 1);
+            SEARCH_STAT_ADD(stats, expanded, 1);
+
+            while (!stack.empty()) {
+                int u = stack.back().first;
+                int e = stack.back().second;
+                if (e == csr.offsets[u + 1]) {
+                    stack.pop_back();
+                    SEARCH_STAT_ADD(stats, pops, 1);
+                    continue;
+                }
+                stack.back().second = e + 1;
+                int v = csr.targets[e];
+                int depth = static_cast<int>(stack.size());
+                SEARCH_STAT_ADD(stats, generated, 1);
+
+                if (v == goal) {
+                    result.found = true;
+                    result.depth = depth;
+                    for (const auto& frame : stack) result.path.push_back(csr.labels[frame.first]);
+                    result.path.push_back(target);
+                    SEARCH_STAT_MAX(stats, peak_memory, capacityBytes(shallowest) + capacityBytes(expanded_in) +
+                                                            capacityBytes(stack));
+                    return result;
+                }
+                if (depth > shallowest[v] || (depth == shallowest[v] && expanded_in[v] == limit)) continue;
+                shallowest[v] = depth;
+                expanded_in[v] = limit;
+                if (depth == limit) {
+                    // Not expanded at this limit; a deeper level may still find something below it
+                    cut_off = cut_off || degree(v) > 1;
+                    continue;
+                }
+                stack.push_back({v, csr.offsets[v]});
+                SEARCH_STAT_ADD(stats, pushes, 1);
+                SEARCH_STAT_ADD(stats, expanded, 1);
+                SEARCH_STAT_MAX(stats, peak_frontier, stack.size());
             }
-            cout << "Not found in level " << depth << endl;
+            if (!cut_off) break;
         }
-        cout << "Target not found!" << endl;
-        return false;
+        SEARCH_STAT_MAX(stats, peak_memory, capacityBytes(shallowest) + capacityBytes(expanded_in) + capacityBytes(stack));
+        return result;
     }
 
     // Bidirectional Search
-    vector<int> bds(int start, int goal) {
+    vector<int> bds(int start, int goal, SearchStats* stats = nullptr) {
+        return bidirectional_bfs(start, goal, nullptr, stats);
+    }
+
+    // Balanced bidirectional BFS: each round expands one whole level of the side whose frontier
+    // has fewer outgoing edges. Membership is a bitset per side and parents and distances are dense
+    // arrays. Every vertex claimed in a level is checked against the other side, and the level is
+    // finished before the shortest meeting is taken, so the returned path is a shortest one.
+    // With a pool, levels are expanded in parallel. Returns the path as labels, or empty.
+    vector<int> bidirectional_bfs(int start, int goal, WorkStealingPool* pool = nullptr, SearchStats* stats = nullptr) {
+        SEARCH_TIMER(stats, "bidirectional_bfs");
         if (start == goal) {
             return {start};
         }
+        if (!connected(start, goal)) return {};
+        freeze();
+        int source = index_of(start), target = index_of(goal);
+        if (source == -1 || target == -1) return {};
 
-        queue<int> frontier_start;
-        queue<int> frontier_goal;
-        frontier_start.push(start);
-        frontier_goal.push(goal);
+        BidirectionalSide sides[2] = {BidirectionalSide(node_count()), BidirectionalSide(node_count())};
+        sides[0].seed(source, degree(source));
+        sides[1].seed(target, degree(target));
+        SEARCH_STAT_ADD(stats, pushes, 2);
+        vector<BfsLevelOutput> outputs(pool ? pool->size() : 1);
 
-        unordered_map<int, int> visited_by_start;
-        unordered_map<int, int> visited_by_goal;
-        visited_by_start[start] = -1;
-        visited_by_goal[goal] = -1;
+        int best_length = numeric_limits<int>::max(), meeting = -1;
+        while (meeting == -1 && !sides[0].frontier.empty() && !sides[1].frontier.empty()) {
+            SEARCH_STAT_MAX(stats, peak_frontier, sides[0].frontier.size() + sides[1].frontier.size());
+            int which = sides[0].frontier_edges <= sides[1].frontier_edges ? 0 : 1;
+            BidirectionalSide& self = sides[which];
+            const BidirectionalSide& other = sides[1 - which];
+            SEARCH_STAT_ADD(stats, expanded, self.frontier.size());
+            SEARCH_STAT_ADD(stats, generated, self.frontier_edges);
 
-        while (!frontier_start.empty() && !frontier_goal.empty()) {
-            int result = forward_frontier(frontier_start, visited_by_start, visited_by_goal);
-            if (result != -1) {
-                return build_path(result, visited_by_start, visited_by_goal);
+            for (BfsLevelOutput& output : outputs) {
+                output.found.clear();
+                output.count = 0;
+                output.degree = 0;
+                output.best_length = numeric_limits<int>::max();
+                output.meeting = -1;
+            }
+            int next_depth = self.depth + 1;
+            auto expand = [&](size_t block, unsigned worker) {
+                BfsLevelOutput& output = outputs[worker];
+                size_t end = min(self.frontier.size(), (block + 1) * kBfsBlock);
+                for (size_t i = block * kBfsBlock; i < end; ++i) {
+                    int u = self.frontier[i];
+                    for (int e = csr.offsets[u]; e < csr.offsets[u + 1]; ++e) {
+                        int v = csr.targets[e];
+                        if (!self.claim(v)) continue;
+                        self.parent[v] = u;
+                        self.distance[v] = next_depth;
+                        output.found.push_back(v);
+                        ++output.count;
+                        output.degree += degree(v);
+                        if (other.contains(v) && next_depth + other.distance[v] < output.best_length) {
+                            output.best_length = next_depth + other.distance[v];
+                            output.meeting = v;
+                        }
+                    }
+                }
+            };
+            size_t blocks = (self.frontier.size() + kBfsBlock - 1) / kBfsBlock;
+            if (pool) {
+                pool->parallelFor(blocks, expand);
+                gather_queue(outputs, self.frontier, *pool);
+            } else {
+                for (size_t block = 0; block < blocks; ++block) expand(block, 0);
+                self.frontier.swap(outputs[0].found);
             }
-            result = forward_frontier(frontier_goal, visited_by_goal, visited_by_start);
-            if (result != -1) {
-                return build_path(result, visited_by_start, visited_by_goal);
+
+            self.depth = next_depth;
+            self.frontier_edges = 0;
+            for (const BfsLevelOutput& output : outputs) {
+                self.frontier_edges += output.degree;
+                SEARCH_STAT_ADD(stats, pushes, output.count);
+                if (output.meeting != -1 && output.best_length < best_length) {
+                    best_length = output.best_length;
+                    meeting = output.meeting;
+                }
             }
         }
-        return {};
+        SEARCH_STAT_MAX(stats, peak_memory, sides[0].memory_bytes(node_count()) + sides[1].memory_bytes(node_count()));
+        if (meeting == -1) return {};
+
+        // Join the two parent chains at the meeting point and translate indices back to labels
+        vector<int> path;
+        for (int v = meeting; v != source; v = sides[0].parent[v]) path.push_back(csr.labels[v]);
+        path.push_back(start);
+        reverse(path.begin(), path.end());
+        for (int v = meeting; v != target;) {
+            v = sides[1].parent[v];
+            path.push_back(csr.labels[v]);
+        }
+        return path;
     }
 
 private:
-    void dfs_helper(int node, unordered_set<int>& visited) {
-        if (visited.find(node) != visited.end()) return;
-        visited.insert(node);
-        cout << node << " ";
-        for (int neighbor : graph[node]) {
-            dfs_helper(neighbor, visited);
+    int component_id(int label) {
+        auto inserted = component_ids.emplace(label, static_cast<int>(component_ids.size()));
+        return inserted.first->second;
+    }
+
+    // Whether the arrays of a mapped file can be indexed safely: the CSR is monotone, ends at
+    // edge_slots and only points at vertices, and the labels strictly increase
+    static bool valid_mapping(const GraphSnapshot& mapped, uint64_t edge_slots, WorkStealingPool& pool) {
+        int n = mapped.node_count;
+        if (!validCsr(mapped.offsets, mapped.targets, n, edge_slots, pool)) return false;
+        atomic<bool> valid{true};
+        pool.parallelFor((static_cast<size_t>(n) + kLoadVertexBlock - 1) / kLoadVertexBlock, [&](size_t block) {
+            int last = static_cast<int>(min<size_t>(n, (block + 1) * kLoadVertexBlock));
+            for (int v = max(1, static_cast<int>(block * kLoadVertexBlock)); v < last; ++v) {
+                if (mapped.labels[v - 1] >= mapped.labels[v]) {
+                    valid.store(false, memory_order_relaxed);
+                    return;
+                }
+            }
+        });
+        return valid.load();
+    }
+
+    static uint64_t align_to_8(uint64_t position) {
+        return (position + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    int degree(int v) const {
+        return csr.offsets[v + 1] - csr.offsets[v];
+    }
+
+    // Concatenate the workers' found lists into the next queue
+    static void gather_queue(const vector<BfsLevelOutput>& outputs, vector<int>& queue, WorkStealingPool& pool) {
+        vector<size_t> offset(outputs.size() + 1, 0);
+        for (size_t i = 0; i < outputs.size(); ++i) offset[i + 1] = offset[i] + outputs[i].found.size();
+        queue.resize(offset.back());
+        pool.parallelFor(outputs.size(), [&](size_t i, unsigned) {
+            copy(outputs[i].found.begin(), outputs[i].found.end(), queue.begin() + offset[i]);
+        });
+    }
+
+    // Parse the lines starting in [begin, end) into chunk; on a malformed line, record its offset
+    // and stop
+    static void parse_edge_chunk(const char* data, size_t begin, size_t end, EdgeChunk& chunk) {
+        chunk.endpoints.reserve((end - begin) / 8);
+        forEachDataLine(data, begin, end, [&](const char* line, const char* line_end) {
+            const char* p = line;
+            skipSeparators(p, line_end);
+            char first = *p;
+            int u, v;
+            bool valid = parseInt(p, line_end, u);
+            if (valid) {
+                skipSeparators(p, line_end);
+                valid = parseInt(p, line_end, v);
+            }
+            if (!valid) {
+                if (line == data && static_cast<unsigned>(first - '0') >= 10 && first != '-' && first != '+') return true;
+                chunk.error = static_cast<size_t>(line - data);
+                return false;
+            }
+            chunk.endpoints.push_back(u);
+            chunk.endpoints.push_back(v);
+            chunk.low = min(chunk.low, min(u, v));
+            chunk.high = max(chunk.high, max(u, v));
+            return true;
+        });
+    }
+
+    // In-place inclusive prefix sum; with values[0] = 0 and each degree at v + 1 this turns a degree
+    // array into CSR offsets
+    static void running_sum(vector<int>& values, WorkStealingPool& pool) {
+        size_t blocks = (values.size() + kLoadVertexBlock - 1) / kLoadVertexBlock;
+        vector<int> block_start(blocks + 1, 0);
+        pool.parallelFor(blocks, [&](size_t block, unsigned) {
+            size_t last = min(values.size(), (block + 1) * kLoadVertexBlock);
+            for (size_t i = block * kLoadVertexBlock + 1; i < last; ++i) values[i] += values[i - 1];
+            block_start[block + 1] = values[last - 1];
+        });
+        for (size_t block = 0; block < blocks; ++block) block_start[block + 1] += block_start[block];
+        pool.parallelFor(blocks, [&](size_t block, unsigned) {
+            size_t last = min(values.size(), (block + 1) * kLoadVertexBlock);
+            for (size_t i = block * kLoadVertexBlock; i < last; ++i) values[i] += block_start[block];
+        });
+    }
+
+    // Rebuild the component index from the snapshot, by snapshot index, in the Afforest style:
+    // link every vertex to its first two neighbors, find the component most vertices already fall
+    // in by sampling, and only walk the remaining edges of vertices outside it. Every edge out of
+    // the big component is still seen from its other endpoint, so the result is exact.
+    void index_components(WorkStealingPool& pool) {
+        components.clear();
+        component_ids.clear();
+        components_by_index = true;
+        int n = node_count();
+        if (n == 0) return;
+        size_t blocks = (static_cast<size_t>(n) + kLoadVertexBlock - 1) / kLoadVertexBlock;
+        auto for_each_vertex = [&](const function<void(int)>& body) {
+            pool.parallelFor(blocks, [&](size_t block, unsigned) {
+                int last = static_cast<int>(min<size_t>(n, (block + 1) * kLoadVertexBlock));
+                for (int v = static_cast<int>(block * kLoadVertexBlock); v < last; ++v) body(v);
+            });
+        };
+        constexpr int kNeighborRounds = 2;
+        for_each_vertex([&](int v) {
+            for (int e = csr.offsets[v]; e < min(csr.offsets[v + 1], csr.offsets[v] + kNeighborRounds); ++e) {
+                components.unite(v, csr.targets[e]);
+            }
+        });
+
+        unordered_map<int, int> votes;
+        uint64_t state = 0x9E3779B97F4A7C15ull;
+        for (int i = 0; i < 1024; ++i) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            ++votes[components.find(static_cast<int>(state % n))];
+        }
+        int largest = max_element(votes.begin(), votes.end(), [](const pair<const int, int>& a, const pair<const int, int>& b) {
+            return a.second < b.second;
+        })->first;
+
+        for_each_vertex([&](int v) {
+            if (components.find(v) == largest) return;
+            for (int e = csr.offsets[v] + kNeighborRounds; e < csr.offsets[v + 1]; ++e) components.unite(v, csr.targets[e]);
+        });
+    }
+
+    // A loaded graph has only its snapshot: fill the adjacency sets and label ids before an edit
+    void thaw() {
+        for (int v = 0; v < node_count(); ++v) {
+            unordered_set<int>& neighbors = graph[csr.labels[v]];
+            for (int e = csr.offsets[v]; e < csr.offsets[v + 1]; ++e) neighbors.insert(csr.labels[csr.targets[e]]);
+            component_ids.emplace(csr.labels[v], v);
         }
+        components_by_index = false;
     }
 
-    int forward_frontier(queue<int>& frontier, unordered_map<int, int>& visited_by_self, unordered_map<int, int>& visited_by_other) {
-        if (frontier.empty()) return -1;
-        int current = frontier.front();
-        frontier.pop();
+    static void pad_to(ofstream& out, uint64_t position) {
+        static const char zeros[8] = {};
+        uint64_t current = static_cast<uint64_t>(out.tellp());
+        if (position > current) out.write(zeros, position - current);
+    }
+
+    template <class Visitor>
+    void depth_first_from(int source, DfsState& state, Visitor& visitor, SearchStats* stats) const {
+        vector<pair<int, int>>& stack = state.stack;
+        stack.clear();
+        state.discovered_bits[source >> 6] |= uint64_t(1) << (source & 63);
+        visitor.discover(source);
+        stack.push_back({source, csr.offsets[source]});
+        SEARCH_STAT_ADD(stats, pushes, 1);
+        SEARCH_STAT_ADD(stats, expanded, 1);
 
-        for (int neighbor : graph[current]) {
-            if (visited_by_self.find(neighbor) == visited_by_self.end()) {
-                visited_by_self[neighbor] = current;
-                frontier.push(neighbor);
+        while (!stack.empty()) {
+            int u = stack.back().first;
+            int e = stack.back().second;
+            if (e == csr.offsets[u + 1]) {
+                stack.pop_back();
+                SEARCH_STAT_ADD(stats, pops, 1);
+                state.finished_bits[u >> 6] |= uint64_t(1) << (u & 63);
+                visitor.finish(u);
+                continue;
             }
-            if (visited_by_other.find(neighbor) != visited_by_other.end()) {
-                return neighbor;
+            stack.back().second = e + 1;
+            int v = csr.targets[e];
+            SEARCH_STAT_ADD(stats, generated, 1);
+            if (state.discovered(v)) {
+                visitor.edge(u, v, state.finished(v) ? DfsEdge::Finished : DfsEdge::Back);
+                continue;
             }
+            visitor.edge(u, v, DfsEdge::Tree);
+            state.discovered_bits[v >> 6] |= uint64_t(1) << (v & 63);
+            visitor.discover(v);
+            stack.push_back({v, csr.offsets[v]});
+            SEARCH_STAT_ADD(stats, pushes, 1);
+            SEARCH_STAT_ADD(stats, expanded, 1);
+            SEARCH_STAT_MAX(stats, peak_frontier, stack.size());
         }
-        return -1;
     }
 
-    vector<int> build_path(int meeting_point, unordered_map<int, int>& visited_by_start, unordered_map<int, int>& visited_by_goal) {
-        vector<int> path_start;
-        int node = meeting_point;
-        while (node != -1) {
-            path_start.push_back(node);
-            node = visited_by_start[node];
+    bool depth_limited_helper(int node, int target, int limit, size_t depth, SearchStats* stats) {
+        SEARCH_STAT_ADD(stats, pushes, 1);
+        SEARCH_STAT_ADD(stats, pops, 1);
+        SEARCH_STAT_MAX(stats, peak_frontier, depth);
+        if (node == target) {
+            cout << "Target Found!" << endl;
+            return true;
+        }
+        if (limit <= 0) {
+            return false;
+        }
+        SEARCH_STAT_ADD(stats, expanded, 1);
+        SEARCH_STAT_ADD(stats, generated, csr.offsets[node + 1] - csr.offsets[node]);
+        for (int e = csr.offsets[node]; e < csr.offsets[node + 1]; ++e) {
+            if (depth_limited_helper(csr.targets[e], target, limit - 1, depth + 1, stats)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// ------------------------ Dynamic Graph ------------------------
+// Undirected graph that keeps serving queries while edges stream in. Queries run on an immutable
+// CSR base plus the append-only delta logs written since that base was built. The writer indexes
+// each log as it fills, and a full log is sealed as one small immutable layer on a chain that later
+// views share, so a query only replays the short active log. compact() (or the background
+// compactor) folds the chain into a new base and swaps it in; replaced views are freed by
+// epoch-based reclamation once no reader can still hold them. Readers never take a lock unless
+// every reader slot is in use.
+class DynamicGraph {
+private:
+    struct EdgeDelta {
+        int u;
+        int v;
+        bool insert;
+    };
+
+    // Single writer (under write_lock), any number of readers. A reader first loads size with
+    // acquire and then only touches entries below it, which are never written again.
+    class DeltaLog {
+    private:
+        static constexpr size_t kChunk = 1024;
+
+        struct Chunk {
+            EdgeDelta entries[kChunk];
+            atomic<Chunk*> next{nullptr};
+        };
+
+        Chunk head;
+        Chunk* tail = &head;
+        atomic<size_t> count{0};
+
+    public:
+        DeltaLog() = default;
+        DeltaLog(const DeltaLog&) = delete;
+        DeltaLog& operator=(const DeltaLog&) = delete;
+
+        ~DeltaLog() {
+            Chunk* chunk = head.next.load(memory_order_relaxed);
+            while (chunk) {
+                Chunk* next = chunk->next.load(memory_order_relaxed);
+                delete chunk;
+                chunk = next;
+            }
+        }
+
+        void append(const EdgeDelta& delta) {
+            size_t n = count.load(memory_order_relaxed);
+            if (n > 0 && n % kChunk == 0) {
+                Chunk* chunk = new Chunk;
+                tail->next.store(chunk, memory_order_relaxed);
+                tail = chunk;
+            }
+            tail->entries[n % kChunk] = delta;
+            count.store(n + 1, memory_order_release);
+        }
+
+        size_t size() const {
+            return count.load(memory_order_acquire);
+        }
+
+        template <class Function>
+        void for_each(Function&& function) const {
+            size_t n = size();
+            const Chunk* chunk = &head;
+            for (size_t i = 0; i < n; ++i) {
+                if (i > 0 && i % kChunk == 0) chunk = chunk->next.load(memory_order_relaxed);
+                function(chunk->entries[i % kChunk]);
+            }
+        }
+    };
+
+    // Immutable CSR over labels, laid out like Graph's snapshot
+    struct DynamicSnapshot {
+        vector<int> labels;
+        vector<int> offsets{0};
+        vector<int> targets;
+
+        int node_count() const {
+            return static_cast<int>(labels.size());
+        }
+
+        int label_of(int id) const {
+            return labels[id];
+        }
+
+        int id_of(int label) const {
+            auto it = lower_bound(labels.begin(), labels.end(), label);
+            return it != labels.end() && *it == label ? static_cast<int>(it - labels.begin()) : -1;
+        }
+
+        bool has_edge(int u, int v) const {
+            int a = id_of(u), b = id_of(v);
+            return a != -1 && b != -1 && binary_search(targets.begin() + offsets[a], targets.begin() + offsets[a + 1], b);
+        }
+
+        template <class Function>
+        void for_each_neighbor(int id, Function&& function) const {
+            for (int e = offsets[id]; e < offsets[id + 1]; ++e) function(targets[e]);
+        }
+
+        size_t memory_bytes() const {
+            return capacityBytes(labels) + capacityBytes(offsets) + capacityBytes(targets);
+        }
+    };
+
+    // The net effect of a run of deltas on the graph below it: inserted edges that were absent
+    // below, deleted edges that were present below, and the nodes it introduced, with ids from
+    // first_id on. The last operation on an edge wins; nodes touched by an insert stay.
+    struct DeltaIndex {
+        unordered_map<int, vector<int>> added;    // label -> labels it gained an edge to
+        unordered_set<uint64_t> added_keys;
+        unordered_set<uint64_t> removed;
+        unordered_map<int, int> extra_ids;
+        vector<int> extra_labels;
+        int first_id = 0;
+
+        int end_id() const {
+            return first_id + static_cast<int>(extra_labels.size());
         }
-        reverse(path_start.begin(), path_start.end());
 
-        vector<int> path_goal;
-        node = visited_by_goal[meeting_point];
-        while (node != -1) {
-            path_goal.push_back(node);
-            node = visited_by_goal[node];
+        // label must be new to everything below and to this index
+        void add_node(int label) {
+            extra_ids.emplace(label, end_id());
+            extra_labels.push_back(label);
+        }
+
+        // present: whether the edge exists just before delta
+        void record(const EdgeDelta& delta, bool present) {
+            if (delta.insert == present) return;
+            uint64_t key = edge_key(delta.u, delta.v);
+            if (delta.insert) {
+                if (removed.erase(key)) return;
+                added_keys.insert(key);
+                added[delta.u].push_back(delta.v);
+                if (delta.u != delta.v) added[delta.v].push_back(delta.u);
+            } else if (added_keys.erase(key)) {
+                unlink(delta.u, delta.v);
+                if (delta.u != delta.v) unlink(delta.v, delta.u);
+            } else {
+                removed.insert(key);
+            }
+        }
+
+    private:
+        void unlink(int label, int neighbor) {
+            auto it = added.find(label);
+            it->second.erase(find(it->second.begin(), it->second.end(), neighbor));
+            if (it->second.empty()) added.erase(it);
+        }
+    };
+
+    // A DeltaIndex applied on top of Below (the base, or the base plus sealed layers), with the
+    // same lookups as Below so overlays can be searched alike
+    template <class Below>
+    struct DeltaOverlay {
+        const Below& below;
+        DeltaIndex index;
+
+        explicit DeltaOverlay(const Below& lower) : below(lower) {
+            index.first_id = below.node_count();
+        }
+
+        void apply(const EdgeDelta& delta) {
+            if (delta.insert) {
+                add_node(delta.u);
+                add_node(delta.v);
+            }
+            index.record(delta, has_edge(delta.u, delta.v));
+        }
+
+        bool has_edge(int u, int v) const {
+            uint64_t key = edge_key(u, v);
+            return index.added_keys.count(key) || (!index.removed.count(key) && below.has_edge(u, v));
+        }
+
+        int node_count() const {
+            return index.end_id();
+        }
+
+        int label_of(int id) const {
+            return id < index.first_id ? below.label_of(id) : index.extra_labels[id - index.first_id];
+        }
+
+        int id_of(int label) const {
+            int id = below.id_of(label);
+            if (id != -1) return id;
+            auto it = index.extra_ids.find(label);
+            return it == index.extra_ids.end() ? -1 : it->second;
+        }
+
+        template <class Function>
+        void for_each_neighbor(int id, Function&& function) const {
+            int label = label_of(id);
+            if (id < index.first_id) {
+                below.for_each_neighbor(id, [&](int neighbor) {
+                    if (index.removed.empty() || !index.removed.count(edge_key(label, below.label_of(neighbor)))) function(neighbor);
+                });
+            }
+            auto it = index.added.find(label);
+            if (it == index.added.end()) return;
+            for (int neighbor : it->second) function(id_of(neighbor));
+        }
+
+    private:
+        void add_node(int label) {
+            if (id_of(label) == -1) index.add_node(label);
+        }
+    };
+
+    // One sealed log, indexed against the base and every older layer. Immutable once published
+    // and shared by later views until compaction folds it into a base.
+    struct SealedLayer {
+        shared_ptr<const SealedLayer> older;    // null for the first layer over the base
+        shared_ptr<DeltaLog> log;               // replayed when the chain is folded or rebased
+        DeltaIndex index;
+    };
+
+    // The base plus a chain of sealed layers, searched newest layer first. Lookups walk the chain,
+    // whose length (sealed deltas / kActiveLogLimit) compaction keeps short.
+    struct SealedChain {
+        const DynamicSnapshot* base;
+        const SealedLayer* top;                 // null when nothing is sealed
+
+        int node_count() const {
+            return top ? top->index.end_id() : base->node_count();
+        }
+
+        int label_of(int id) const {
+            for (const SealedLayer* layer = top; layer; layer = layer->older.get()) {
+                if (id >= layer->index.first_id) return layer->index.extra_labels[id - layer->index.first_id];
+            }
+            return base->labels[id];
+        }
+
+        int id_of(int label) const {
+            for (const SealedLayer* layer = top; layer; layer = layer->older.get()) {
+                auto it = layer->index.extra_ids.find(label);
+                if (it != layer->index.extra_ids.end()) return it->second;
+            }
+            return base->id_of(label);
+        }
+
+        bool has_edge(int u, int v) const {
+            uint64_t key = edge_key(u, v);
+            for (const SealedLayer* layer = top; layer; layer = layer->older.get()) {
+                if (layer->index.added_keys.count(key)) return true;
+                if (layer->index.removed.count(key)) return false;
+            }
+            return base->has_edge(u, v);
+        }
+
+        // An edge from the base or a layer counts unless a newer layer removed it
+        template <class Function>
+        void for_each_neighbor(int id, Function&& function) const {
+            int label = label_of(id);
+            auto removed_above = [&](const SealedLayer* owner, int neighbor) {
+                uint64_t key = edge_key(label, neighbor);
+                for (const SealedLayer* layer = top; layer != owner; layer = layer->older.get()) {
+                    if (!layer->index.removed.empty() && layer->index.removed.count(key)) return true;
+                }
+                return false;
+            };
+            if (id < base->node_count()) {
+                base->for_each_neighbor(id, [&](int neighbor) {
+                    if (!removed_above(nullptr, base->labels[neighbor])) function(neighbor);
+                });
+            }
+            for (const SealedLayer* layer = top; layer; layer = layer->older.get()) {
+                auto it = layer->index.added.find(label);
+                if (it == layer->index.added.end()) continue;
+                for (int neighbor : it->second) {
+                    if (!removed_above(layer, neighbor)) function(id_of(neighbor));
+                }
+            }
+        }
+    };
+
+    // What readers load: a base, the chain of layers sealed since it was built and the active
+    // log, the only one writers append to
+    struct View {
+        shared_ptr<const DynamicSnapshot> base;
+        shared_ptr<const SealedLayer> sealed;
+        shared_ptr<DeltaLog> log;
+        size_t sealed_deltas;
+
+        SealedChain chain() const {
+            return SealedChain{base.get(), sealed.get()};
         }
+    };
 
-        path_start.insert(path_start.end(), path_goal.begin(), path_goal.end());
-        return path_start;
+    // A reader announces the epoch it started in; a view retired in epoch r is freed once every
+    // announced epoch is above r. Slots are claimed with a CAS, so readers never wait on writers;
+    // a reader that finds every slot taken announces in the locked overflow list instead.
+    struct alignas(64) ReaderSlot {
+        atomic<uint64_t> epoch{0};
+    };
+
+    class ReadGuard {
+    private:
+        const DynamicGraph& owner;
+        uint64_t epoch = 0;
+        size_t slot;
+
+    public:
+        const View* view;
+
+        explicit ReadGuard(const DynamicGraph& graph) : owner(graph), slot(graph.pin(epoch)) {
+            view = owner.current.load();
+        }
+
+        ~ReadGuard() {
+            owner.unpin(slot, epoch);
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+    };
+
+    static constexpr size_t kReaderSlots = 128;
+    static constexpr size_t kActiveLogLimit = 256;    // deltas a query replays at most
+
+    atomic<View*> current;
+    mutable ReaderSlot reader_slots[kReaderSlots];
+    mutable mutex overflow_lock;
+    mutable multiset<uint64_t> overflow_epochs;      // readers that found every slot taken
+    atomic<uint64_t> global_epoch{1};
+
+    mutex write_lock;                              // writers, view swaps and the retired list
+    mutex compaction_lock;                         // one compaction at a time
+    vector<pair<uint64_t, View*>> retired;
+
+    // Writer state under write_lock: every pending delta indexed against the current base, which
+    // answers "is this edge / node already there" in O(1), and the layer the active log builds
+    shared_ptr<const DynamicSnapshot> pending_base;
+    unique_ptr<DeltaOverlay<DynamicSnapshot>> pending;
+    DeltaIndex active_index;
+
+    condition_variable compaction_wanted;
+    thread compactor;
+    size_t compaction_threshold = 0;
+    bool background = false;
+    bool stopping = false;
+
+public:
+    DynamicGraph()
+        : current(new View{make_shared<const DynamicSnapshot>(), nullptr, make_shared<DeltaLog>(), 0}) {
+        rebase_pending(current.load()->base);
+    }
+
+    DynamicGraph(const DynamicGraph&) = delete;
+    DynamicGraph& operator=(const DynamicGraph&) = delete;
+
+    // Readers must be gone by now
+    ~DynamicGraph() {
+        stop_background_compaction();
+        delete current.load();
+        for (auto& entry : retired) delete entry.second;
+    }
+
+    // Add undirected edge
+    void add_edges(int u, int v) {
+        append({u, v, true});
+    }
+
+    void remove_edge(int u, int v) {
+        append({u, v, false});
+    }
+
+    // Deltas not yet folded into the base
+    size_t delta_size() const {
+        ReadGuard guard(*this);
+        return guard.view->sealed_deltas + guard.view->log->size();
+    }
+
+    bool has_edge(int u, int v) const {
+        ReadGuard guard(*this);
+        const View& view = *guard.view;
+        bool present = view.chain().has_edge(u, v);
+        uint64_t key = edge_key(u, v);
+        view.log->for_each([&](const EdgeDelta& delta) {
+            if (edge_key(delta.u, delta.v) == key) present = delta.insert;
+        });
+        return present;
+    }
+
+    // BFS shortest path over the base plus pending deltas; labels, empty if unreachable
+    vector<int> shortest_path(int start, int goal, SearchStats* stats = nullptr) const {
+        SEARCH_TIMER(stats, "dynamic_bfs");
+        ReadGuard guard(*this);
+        const View& view = *guard.view;
+        SealedChain chain = view.chain();
+        DeltaOverlay<SealedChain> overlay(chain);
+        view.log->for_each([&](const EdgeDelta& delta) { overlay.apply(delta); });
+        int source = overlay.id_of(start), target = overlay.id_of(goal);
+        if (source == -1 || target == -1) return {};
+
+        vector<int> parent(overlay.node_count(), -1);
+        vector<int> frontier = {source};
+        parent[source] = source;
+        SEARCH_STAT_ADD(stats, pushes, 1);
+        for (size_t head = 0; head < frontier.size() && parent[target] == -1; ++head) {
+            int u = frontier[head];
+            SEARCH_STAT_ADD(stats, expanded, 1);
+            overlay.for_each_neighbor(u, [&](int v) {
+                SEARCH_STAT_ADD(stats, generated, 1);
+                if (parent[v] != -1) return;
+                parent[v] = u;
+                frontier.push_back(v);
+                SEARCH_STAT_ADD(stats, pushes, 1);
+            });
+            SEARCH_STAT_MAX(stats, peak_frontier, frontier.size() - head - 1);
+        }
+        SEARCH_STAT_MAX(stats, peak_memory, view.base->memory_bytes() + capacityBytes(parent) + capacityBytes(frontier));
+        if (parent[target] == -1) return {};
+
+        vector<int> path;
+        for (int v = target; v != source; v = parent[v]) path.push_back(overlay.label_of(v));
+        path.push_back(start);
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // Fold every delta written so far into a new base. Writers keep appending to a fresh log
+    // while the merge runs and are only held for the two pointer swaps.
+    void compact() {
+        lock_guard<mutex> compaction_guard(compaction_lock);
+        shared_ptr<const DynamicSnapshot> old_base;
+        shared_ptr<const SealedLayer> folded;
+        {
+            lock_guard<mutex> guard(write_lock);
+            if (pending_locked() == 0) return;
+            seal_active_log();
+            old_base = current.load()->base;
+            folded = current.load()->sealed;
+        }
+
+        // Replay the chain oldest layer first onto one overlay of the old base
+        vector<const SealedLayer*> layers;
+        for (const SealedLayer* layer = folded.get(); layer; layer = layer->older.get()) layers.push_back(layer);
+        DeltaOverlay<DynamicSnapshot> overlay(*old_base);
+        for (auto it = layers.rbegin(); it != layers.rend(); ++it) {
+            (*it)->log->for_each([&](const EdgeDelta& delta) { overlay.apply(delta); });
+        }
+        shared_ptr<const DynamicSnapshot> base = merge(overlay);
+
+        {
+            lock_guard<mutex> guard(write_lock);
+            // Only compaction drops layers, so the current chain still ends in the folded one.
+            // Layers sealed during the merge and the active log are indexed again on the new base.
+            View* old = current.load();
+            layers.clear();
+            for (const SealedLayer* layer = old->sealed.get(); layer != folded.get(); layer = layer->older.get()) {
+                layers.push_back(layer);
+            }
+            rebase_pending(base);
+            shared_ptr<const SealedLayer> sealed;
+            size_t sealed_deltas = 0;
+            for (auto it = layers.rbegin(); it != layers.rend(); ++it) {
+                (*it)->log->for_each([&](const EdgeDelta& delta) { index_delta(delta); });
+                sealed = make_shared<const SealedLayer>(SealedLayer{sealed, (*it)->log, move(active_index)});
+                sealed_deltas += (*it)->log->size();
+                active_index = DeltaIndex();
+                active_index.first_id = pending->node_count();
+            }
+            old->log->for_each([&](const EdgeDelta& delta) { index_delta(delta); });
+            publish(new View{base, sealed, old->log, sealed_deltas});
+        }
+        reclaim();
+    }
+
+    // Compact on a background thread whenever threshold deltas are pending
+    void start_background_compaction(size_t threshold) {
+        stop_background_compaction();
+        {
+            lock_guard<mutex> guard(write_lock);
+            compaction_threshold = max<size_t>(threshold, 1);
+            background = true;
+            stopping = false;
+        }
+        compactor = thread([this] {
+            unique_lock<mutex> guard(write_lock);
+            while (true) {
+                compaction_wanted.wait(guard, [this] { return stopping || pending_locked() >= compaction_threshold; });
+                if (stopping) return;
+                guard.unlock();
+                compact();
+                guard.lock();
+            }
+        });
+    }
+
+    void stop_background_compaction() {
+        if (!compactor.joinable()) return;
+        {
+            lock_guard<mutex> guard(write_lock);
+            background = false;
+            stopping = true;
+        }
+        compaction_wanted.notify_one();
+        compactor.join();
+    }
+
+private:
+    static uint64_t edge_key(int u, int v) {
+        if (u > v) swap(u, v);
+        return uint64_t(static_cast<uint32_t>(u)) << 32 | static_cast<uint32_t>(v);
+    }
+
+    void append(const EdgeDelta& delta) {
+        bool wake, sealed;
+        {
+            lock_guard<mutex> guard(write_lock);
+            DeltaLog& log = *current.load()->log;
+            index_delta(delta);
+            log.append(delta);
+            sealed = log.size() >= kActiveLogLimit;
+            if (sealed) seal_active_log();
+            wake = background && pending_locked() >= compaction_threshold;
+        }
+        if (wake) compaction_wanted.notify_one();
+        if (sealed) reclaim();
+    }
+
+    // Caller holds write_lock. Record delta in the active layer, judged against every delta
+    // before it, and keep pending in step; O(1) expected.
+    void index_delta(const EdgeDelta& delta) {
+        if (delta.insert) {
+            if (pending->id_of(delta.u) == -1) active_index.add_node(delta.u);
+            if (delta.v != delta.u && pending->id_of(delta.v) == -1) active_index.add_node(delta.v);
+        }
+        active_index.record(delta, pending->has_edge(delta.u, delta.v));
+        pending->apply(delta);
+    }
+
+    // Caller holds write_lock. Start indexing from an empty set of deltas over base.
+    void rebase_pending(shared_ptr<const DynamicSnapshot> base) {
+        pending.reset(new DeltaOverlay<DynamicSnapshot>(*base));
+        pending_base = move(base);
+        active_index = DeltaIndex();
+        active_index.first_id = pending->node_count();
+    }
+
+    // Caller holds write_lock. Publish the active log's layer, already built by index_delta, on
+    // top of the chain and give writers a fresh log; nothing older is copied or revisited.
+    void seal_active_log() {
+        View* old = current.load();
+        if (old->log->size() == 0) return;
+        auto sealed = make_shared<const SealedLayer>(SealedLayer{old->sealed, old->log, move(active_index)});
+        active_index = DeltaIndex();
+        active_index.first_id = pending->node_count();
+        publish(new View{old->base, sealed, make_shared<DeltaLog>(), old->sealed_deltas + old->log->size()});
+    }
+
+    size_t pending_locked() const {
+        const View* view = current.load();
+        return view->sealed_deltas + view->log->size();
+    }
+
+    // Caller holds write_lock. Readers that announced an epoch up to the returned one may still
+    // be using the old view; anyone announcing later loads the new one.
+    void publish(View* view) {
+        View* old = current.exchange(view);
+        retired.push_back({global_epoch.fetch_add(1), old});
+    }
+
+    // Announce the current epoch in a free slot, or in the overflow list after one sweep finds
+    // every slot taken. Returns the slot, kReaderSlots for the overflow list.
+    size_t pin(uint64_t& epoch) const {
+        size_t start = hash<thread::id>()(this_thread::get_id()) % kReaderSlots;
+        for (size_t i = 0; i < kReaderSlots; ++i) {
+            uint64_t expected = 0;
+            epoch = global_epoch.load();
+            if (reader_slots[(start + i) % kReaderSlots].epoch.compare_exchange_strong(expected, epoch)) return (start + i) % kReaderSlots;
+        }
+        lock_guard<mutex> guard(overflow_lock);
+        epoch = global_epoch.load();
+        overflow_epochs.insert(epoch);
+        return kReaderSlots;
+    }
+
+    void unpin(size_t slot, uint64_t epoch) const {
+        if (slot < kReaderSlots) {
+            reader_slots[slot].epoch.store(0);
+            return;
+        }
+        lock_guard<mutex> guard(overflow_lock);
+        overflow_epochs.erase(overflow_epochs.find(epoch));
+    }
+
+    void reclaim() {
+        vector<View*> doomed;
+        {
+            lock_guard<mutex> guard(write_lock);
+            uint64_t oldest = numeric_limits<uint64_t>::max();
+            for (const ReaderSlot& slot : reader_slots) {
+                uint64_t epoch = slot.epoch.load();
+                if (epoch != 0) oldest = min(oldest, epoch);
+            }
+            {
+                lock_guard<mutex> overflow_guard(overflow_lock);
+                if (!overflow_epochs.empty()) oldest = min(oldest, *overflow_epochs.begin());
+            }
+            auto keep = partition(retired.begin(), retired.end(), [&](const pair<uint64_t, View*>& entry) { return entry.first >= oldest; });
+            for (auto it = keep; it != retired.end(); ++it) doomed.push_back(it->second);
+            retired.erase(keep, retired.end());
+        }
+        // Freeing a view may release a whole base, so do it outside the lock
+        for (View* view : doomed) delete view;
+    }
+
+    // New base = old base with the overlay applied; neighbor lists stay sorted
+    static shared_ptr<const DynamicSnapshot> merge(const DeltaOverlay<DynamicSnapshot>& overlay) {
+        const DynamicSnapshot& base = overlay.below;
+        auto merged = make_shared<DynamicSnapshot>();
+        vector<int>& labels = merged->labels;
+        labels = base.labels;
+        labels.insert(labels.end(), overlay.index.extra_labels.begin(), overlay.index.extra_labels.end());
+        sort(labels.begin(), labels.end());
+
+        merged->offsets.assign(labels.size() + 1, 0);
+        vector<int> neighbors;
+        for (size_t i = 0; i < labels.size(); ++i) {
+            neighbors.clear();
+            overlay.for_each_neighbor(overlay.id_of(labels[i]), [&](int id) { neighbors.push_back(overlay.label_of(id)); });
+            sort(neighbors.begin(), neighbors.end());
+            for (int neighbor : neighbors) {
+                merged->targets.push_back(static_cast<int>(lower_bound(labels.begin(), labels.end(), neighbor) - labels.begin()));
+            }
+            merged->offsets[i + 1] = static_cast<int>(merged->targets.size());
+        }
+        return merged;
     }
 };
 
@@ -185,6 +1784,13 @@ int main() {
     cout << "BFS: ";
     g.bfs(3);
 
+    cout << "Parallel BFS (node:distance): ";
+    BfsTree tree = g.parallel_bfs(3);
+    for (int i = 0; i < g.node_count(); ++i) {
+        cout << g.label_of(i) << ":" << tree.distance[i] << " ";
+    }
+    cout << endl;
+
     cout << "DFS: ";
     g.dfs(3);
 
@@ -207,5 +1813,47 @@ int main() {
         cout << "No matched entries!" << endl;
     }
 
+    // Streaming updates: queries see pending deltas, compaction folds them into a new base
+    DynamicGraph live;
+    live.add_edges(3, 6);
+    live.add_edges(6, 7);
+    live.compact();
+    live.add_edges(3, 7);
+    live.remove_edge(6, 7);
+    cout << "Dynamic Graph path: ";
+    for (int node : live.shortest_path(3, 7)) {
+        cout << node << " ";
+    }
+    cout << "(" << live.delta_size() << " pending deltas)" << endl;
+
+    // Parallel BFS called from two threads at once shares the pool; every tree must match the
+    // distances found on a one-thread pool
+    Graph mesh;
+    for (int v = 0; v < 2000; ++v) {
+        mesh.add_edges(v, (v + 1) % 2000);
+        mesh.add_edges(v, v * 7 % 2000);
+    }
+    mesh.freeze();
+    WorkStealingPool single(1);
+    vector<vector<int>> expected;
+    for (int round = 0; round < 10; ++round) expected.push_back(mesh.parallel_bfs(round * 97, single).distance);
+    atomic<int> matching{0};
+    auto traverse = [&] {
+        for (int round = 0; round < 10; ++round) matching += mesh.parallel_bfs(round * 97).distance == expected[round];
+    };
+    thread first(traverse), second(traverse);
+    first.join();
+    second.join();
+    cout << "Concurrent parallel BFS: " << matching << " of 20 trees match" << endl;
+
+#ifdef SEARCH_STATS
+    SearchStats stats;
+    g.bds(3, 7, &stats);
+    cout << "Bidirectional Search stats: expanded " << stats.expanded << ", generated " << stats.generated
+         << ", peak frontier " << stats.peak_frontier << ", peak memory " << stats.peak_memory << " bytes, "
+         << stats.wall_ns << " ns" << endl;
+    LatencyHistogram::dumpJson(cout);
+#endif
+
     return 0;
 }